@@ -17,6 +17,7 @@
 #include <Fwog/Pipeline.h>
 #include <Fwog/Rendering.h>
 #include <Fwog/Shader.h>
+#include <Fwog/ShaderCache.h>
 #include <Fwog/Texture.h>
 #include <Fwog/Timer.h>
 
@@ -176,52 +177,60 @@ static constexpr auto sceneInputBindingDescs = std::array{
   },
 };
 
-static Fwog::GraphicsPipeline CreateScenePipeline()
+static Fwog::GraphicsPipeline CreateScenePipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vs = Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Application::LoadFile("shaders/SceneDeferred.vert.glsl"));
-  auto fs = Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Application::LoadFile("shaders/SceneDeferred.frag.glsl"));
+  auto vs = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                     Application::LoadFile("shaders/SceneDeferred.vert.glsl"));
+  auto fs = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                     Application::LoadFile("shaders/SceneDeferred.frag.glsl"));
 
   return Fwog::GraphicsPipeline({
-    .vertexShader = &vs,
-    .fragmentShader = &fs,
+    .vertexShader = vs.get(),
+    .fragmentShader = fs.get(),
     .vertexInputState = {sceneInputBindingDescs},
     .depthState = {.depthTestEnable = true, .depthWriteEnable = true},
   });
 }
 
-static Fwog::GraphicsPipeline CreateShadowPipeline()
+static Fwog::GraphicsPipeline CreateShadowPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vs = Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Application::LoadFile("shaders/SceneDeferred.vert.glsl"));
-  auto fs = Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Application::LoadFile("shaders/RSMScene.frag.glsl"));
+  auto vs = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                     Application::LoadFile("shaders/SceneDeferred.vert.glsl"));
+  auto fs = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                     Application::LoadFile("shaders/RSMScene.frag.glsl"));
 
   return Fwog::GraphicsPipeline({
-    .vertexShader = &vs,
-    .fragmentShader = &fs,
+    .vertexShader = vs.get(),
+    .fragmentShader = fs.get(),
     .vertexInputState = {sceneInputBindingDescs},
     .depthState = {.depthTestEnable = true, .depthWriteEnable = true},
   });
 }
 
-static Fwog::GraphicsPipeline CreateShadingPipeline()
+static Fwog::GraphicsPipeline CreateShadingPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vs = Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Application::LoadFile("shaders/FullScreenTri.vert.glsl"));
-  auto fs = Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Application::LoadFile("shaders/ShadeDeferred.frag.glsl"));
+  auto vs = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                     Application::LoadFile("shaders/FullScreenTri.vert.glsl"));
+  auto fs = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                     Application::LoadFile("shaders/ShadeDeferred.frag.glsl"));
 
   return Fwog::GraphicsPipeline({
-    .vertexShader = &vs,
-    .fragmentShader = &fs,
+    .vertexShader = vs.get(),
+    .fragmentShader = fs.get(),
     .rasterizationState = {.cullMode = Fwog::CullMode::NONE},
   });
 }
 
-static Fwog::GraphicsPipeline CreateDebugTexturePipeline()
+static Fwog::GraphicsPipeline CreateDebugTexturePipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vs = Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Application::LoadFile("shaders/FullScreenTri.vert.glsl"));
-  auto fs = Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Application::LoadFile("shaders/Texture.frag.glsl"));
+  auto vs = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                     Application::LoadFile("shaders/FullScreenTri.vert.glsl"));
+  auto fs = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                     Application::LoadFile("shaders/Texture.frag.glsl"));
 
   return Fwog::GraphicsPipeline({
-    .vertexShader = &vs,
-    .fragmentShader = &fs,
+    .vertexShader = vs.get(),
+    .fragmentShader = fs.get(),
     .rasterizationState = {.cullMode = Fwog::CullMode::NONE},
   });
 }
@@ -277,6 +286,9 @@ private:
   Fwog::TypedBuffer<GlobalUniforms> globalUniformsBuffer;
   Fwog::TypedBuffer<ShadingUniforms> shadingUniformsBuffer;
 
+  // Shaders used by more than one pipeline are only compiled once
+  Fwog::ShaderCache shaderCache;
+
   Fwog::GraphicsPipeline scenePipeline;
   Fwog::GraphicsPipeline rsmScenePipeline;
   Fwog::GraphicsPipeline shadingPipeline;
@@ -293,10 +305,10 @@ DeferredApplication::DeferredApplication(const Application::CreateInfo& createIn
     globalUniformsBuffer(Fwog::BufferStorageFlag::DYNAMIC_STORAGE),
     shadingUniformsBuffer(Fwog::BufferStorageFlag::DYNAMIC_STORAGE),
     // Create the pipelines used in the application
-    scenePipeline(CreateScenePipeline()),
-    rsmScenePipeline(CreateShadowPipeline()),
-    shadingPipeline(CreateShadingPipeline()),
-    debugTexturePipeline(CreateDebugTexturePipeline())
+    scenePipeline(CreateScenePipeline(shaderCache)),
+    rsmScenePipeline(CreateShadowPipeline(shaderCache)),
+    shadingPipeline(CreateShadingPipeline(shaderCache)),
+    debugTexturePipeline(CreateDebugTexturePipeline(shaderCache))
 {
   ImGui::GetIO().Fonts->AddFontFromFileTTF("textures/RobotoCondensed-Regular.ttf", 18);
 
@@ -384,17 +396,17 @@ void DeferredApplication::OnRender([[maybe_unused]] double dt)
   Fwog::RenderAttachment gAlbedoAttachment{
     .texture = &frame.gAlbedo.value(),
     .clearValue = Fwog::ClearColorValue{.1f, .3f, .5f, 0.0f},
-    .clearOnLoad = true,
+    .loadOp = Fwog::AttachmentLoadOp::CLEAR,
   };
   Fwog::RenderAttachment gNormalAttachment{
     .texture = &frame.gNormal.value(),
     .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-    .clearOnLoad = false,
+    .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
   };
   Fwog::RenderAttachment gDepthAttachment{
     .texture = &frame.gDepth.value(),
     .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-    .clearOnLoad = true,
+    .loadOp = Fwog::AttachmentLoadOp::CLEAR,
   };
   Fwog::RenderAttachment cgAttachments[] = {gAlbedoAttachment, gNormalAttachment};
   Fwog::BeginRendering({
@@ -419,17 +431,17 @@ void DeferredApplication::OnRender([[maybe_unused]] double dt)
   Fwog::RenderAttachment rcolorAttachment{
     .texture = &rsmFlux,
     .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-    .clearOnLoad = false,
+    .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
   };
   Fwog::RenderAttachment rnormalAttachment{
     .texture = &rsmNormal,
     .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-    .clearOnLoad = false,
+    .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
   };
   Fwog::RenderAttachment rdepthAttachment{
     .texture = &rsmDepth,
     .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-    .clearOnLoad = true,
+    .loadOp = Fwog::AttachmentLoadOp::CLEAR,
   };
   Fwog::RenderAttachment crAttachments[] = {rcolorAttachment, rnormalAttachment};
   Fwog::BeginRendering({
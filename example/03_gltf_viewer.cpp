@@ -10,6 +10,7 @@
 #include <Fwog/Shader.h>
 #include <Fwog/Texture.h>
 #include <Fwog/Timer.h>
+#include <Fwog/UploadRing.h>
 
 #include <stb_image.h>
 
@@ -198,7 +199,8 @@ private:
 
   Fwog::TypedBuffer<GlobalUniforms> globalUniformsBuffer;
   Fwog::TypedBuffer<ShadingUniforms> shadingUniformsBuffer;
-  Fwog::TypedBuffer<Utility::GpuMaterial> materialUniformsBuffer;
+  // per-draw material uniforms
+  Fwog::UploadRing uploadRing;
 
   Fwog::GraphicsPipeline scenePipeline;
   Fwog::GraphicsPipeline rsmScenePipeline;
@@ -223,7 +225,7 @@ GltfViewerApplication::GltfViewerApplication(const Application::CreateInfo& crea
     // Create constant-size buffers
     globalUniformsBuffer(Fwog::BufferStorageFlag::DYNAMIC_STORAGE),
     shadingUniformsBuffer(Fwog::BufferStorageFlag::DYNAMIC_STORAGE),
-    materialUniformsBuffer(Fwog::BufferStorageFlag::DYNAMIC_STORAGE),
+    uploadRing(1 << 20),
     // Create the pipelines used in the application
     scenePipeline(CreateScenePipeline()),
     rsmScenePipeline(CreateShadowPipeline()),
@@ -301,6 +303,8 @@ void GltfViewerApplication::OnUpdate([[maybe_unused]] double dt) {}
 
 void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
 {
+  uploadRing.BeginFrame();
+
   std::swap(frame.gDepth, frame.gDepthPrev);
   std::swap(frame.gNormal, frame.gNormalPrev);
 
@@ -338,17 +342,17 @@ void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
     Fwog::RenderAttachment gAlbedoAttachment{
       .texture = &frame.gAlbedo.value(),
                                             .clearValue = Fwog::ClearColorValue{.1f, .3f, .5f, 0.0f},
-      .clearOnLoad = true,
+      .loadOp = Fwog::AttachmentLoadOp::CLEAR,
     };
     Fwog::RenderAttachment gNormalAttachment{
       .texture = &frame.gNormal.value(),
                                              .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-      .clearOnLoad = false,
+      .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
     };
     Fwog::RenderAttachment gDepthAttachment{
       .texture = &frame.gDepth.value(),
                                             .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-      .clearOnLoad = true,
+      .loadOp = Fwog::AttachmentLoadOp::CLEAR,
     };
     Fwog::RenderAttachment cgAttachments[] = {gAlbedoAttachment, gNormalAttachment};
     Fwog::BeginRendering({
@@ -359,14 +363,14 @@ void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
     });
     Fwog::Cmd::BindGraphicsPipeline(scenePipeline);
     Fwog::Cmd::BindUniformBuffer(0, globalUniformsBuffer, 0, globalUniformsBuffer.Size());
-    Fwog::Cmd::BindUniformBuffer(2, materialUniformsBuffer, 0, materialUniformsBuffer.Size());
 
     Fwog::Cmd::BindStorageBuffer(1, *meshUniformBuffer, 0, meshUniformBuffer->Size());
     for (uint32_t i = 0; i < static_cast<uint32_t>(scene.meshes.size()); i++)
     {
       const auto& mesh = scene.meshes[i];
       const auto& material = scene.materials[mesh.materialIdx];
-      materialUniformsBuffer.SubData(material.gpuMaterial, 0);
+      const auto materialUniforms = uploadRing.Upload(material.gpuMaterial);
+      Fwog::Cmd::BindUniformBuffer(2, *materialUniforms.buffer, materialUniforms.offset, materialUniforms.size);
       if (material.gpuMaterial.flags & Utility::MaterialFlagBit::HAS_BASE_COLOR_TEXTURE)
       {
         const auto& textureSampler = scene.textureSamplers[material.baseColorTextureIdx];
@@ -386,17 +390,17 @@ void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
     Fwog::RenderAttachment rcolorAttachment{
       .texture = &rsmFlux,
                                             .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-      .clearOnLoad = false,
+      .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
     };
     Fwog::RenderAttachment rnormalAttachment{
       .texture = &rsmNormal,
                                              .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-      .clearOnLoad = false,
+      .loadOp = Fwog::AttachmentLoadOp::DONT_CARE,
     };
     Fwog::RenderAttachment rdepthAttachment{
       .texture = &rsmDepth,
                                             .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-      .clearOnLoad = true,
+      .loadOp = Fwog::AttachmentLoadOp::CLEAR,
     };
     Fwog::RenderAttachment crAttachments[] = {rcolorAttachment, rnormalAttachment};
     Fwog::BeginRendering({
@@ -408,14 +412,14 @@ void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
     Fwog::Cmd::BindGraphicsPipeline(rsmScenePipeline);
     Fwog::Cmd::BindUniformBuffer(0, globalUniformsBuffer, 0, globalUniformsBuffer.Size());
     Fwog::Cmd::BindUniformBuffer(1, shadingUniformsBuffer, 0, shadingUniformsBuffer.Size());
-    Fwog::Cmd::BindUniformBuffer(2, materialUniformsBuffer, 0, materialUniformsBuffer.Size());
 
     Fwog::Cmd::BindStorageBuffer(1, *meshUniformBuffer, 0, meshUniformBuffer->Size());
     for (uint32_t i = 0; i < static_cast<uint32_t>(scene.meshes.size()); i++)
     {
       const auto& mesh = scene.meshes[i];
       const auto& material = scene.materials[mesh.materialIdx];
-      materialUniformsBuffer.SubData(material.gpuMaterial, 0);
+      const auto materialUniforms = uploadRing.Upload(material.gpuMaterial);
+      Fwog::Cmd::BindUniformBuffer(2, *materialUniforms.buffer, materialUniforms.offset, materialUniforms.size);
       if (material.gpuMaterial.flags & Utility::MaterialFlagBit::HAS_BASE_COLOR_TEXTURE)
       {
         const auto& textureSampler = scene.textureSamplers[material.baseColorTextureIdx];
@@ -511,6 +515,8 @@ void GltfViewerApplication::OnRender([[maybe_unused]] double dt)
     }
   }
   Fwog::EndRendering();
+
+  uploadRing.EndFrame();
 }
 
 void GltfViewerApplication::OnGui([[maybe_unused]] double dt)
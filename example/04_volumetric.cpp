@@ -22,6 +22,7 @@
 #include <Fwog/Pipeline.h>
 #include <Fwog/Rendering.h>
 #include <Fwog/Shader.h>
+#include <Fwog/ShaderCache.h>
 #include <Fwog/Texture.h>
 #include <Fwog/Timer.h>
 
@@ -161,28 +162,28 @@ std::array<Fwog::VertexInputBindingDescription, 3> GetSceneInputBindingDescs()
   return {descPos, descNormal, descUV};
 }
 
-Fwog::GraphicsPipeline CreateScenePipeline()
+Fwog::PendingPipeline<Fwog::GraphicsPipeline> CreateScenePipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vertexShader =
-      Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Utility::LoadFile("shaders/SceneDeferredSimple.vert.glsl"));
-  auto fragmentShader =
-      Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Utility::LoadFile("shaders/SceneDeferredSimple.frag.glsl"));
-
-  return Fwog::GraphicsPipeline({
-      .vertexShader = &vertexShader,
-      .fragmentShader = &fragmentShader,
+  auto vertexShader = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                               Utility::LoadFile("shaders/SceneDeferredSimple.vert.glsl"));
+  auto fragmentShader = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                                 Utility::LoadFile("shaders/SceneDeferredSimple.frag.glsl"));
+
+  return Fwog::CompileGraphicsPipelineAsync({
+      .vertexShader = vertexShader.get(),
+      .fragmentShader = fragmentShader.get(),
       .vertexInputState = {GetSceneInputBindingDescs()},
       .depthState = {.depthTestEnable = true, .depthWriteEnable = true, .depthCompareOp = Fwog::CompareOp::GREATER},
   });
 }
 
-Fwog::GraphicsPipeline CreateShadowPipeline()
+Fwog::PendingPipeline<Fwog::GraphicsPipeline> CreateShadowPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vertexShader =
-      Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Utility::LoadFile("shaders/SceneDeferredSimple.vert.glsl"));
+  auto vertexShader = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                               Utility::LoadFile("shaders/SceneDeferredSimple.vert.glsl"));
 
-  return Fwog::GraphicsPipeline({
-      .vertexShader = &vertexShader,
+  return Fwog::CompileGraphicsPipelineAsync({
+      .vertexShader = vertexShader.get(),
       .vertexInputState = {GetSceneInputBindingDescs()},
       .rasterizationState =
           {
@@ -194,57 +195,58 @@ Fwog::GraphicsPipeline CreateShadowPipeline()
   });
 }
 
-Fwog::GraphicsPipeline CreateShadingPipeline()
+Fwog::PendingPipeline<Fwog::GraphicsPipeline> CreateShadingPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vertexShader =
-      Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Utility::LoadFile("shaders/FullScreenTri.vert.glsl"));
-  auto fragmentShader =
-      Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Utility::LoadFile("shaders/ShadeDeferredSimple.frag.glsl"));
-
-  return Fwog::GraphicsPipeline({
-      .vertexShader = &vertexShader,
-      .fragmentShader = &fragmentShader,
+  auto vertexShader = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                               Utility::LoadFile("shaders/FullScreenTri.vert.glsl"));
+  auto fragmentShader = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                                 Utility::LoadFile("shaders/ShadeDeferredSimple.frag.glsl"));
+
+  return Fwog::CompileGraphicsPipelineAsync({
+      .vertexShader = vertexShader.get(),
+      .fragmentShader = fragmentShader.get(),
       .rasterizationState = {.cullMode = Fwog::CullMode::NONE},
       .depthState = {.depthTestEnable = false, .depthWriteEnable = false},
   });
 }
 
-Fwog::GraphicsPipeline CreateDebugTexturePipeline()
+Fwog::PendingPipeline<Fwog::GraphicsPipeline> CreateDebugTexturePipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto vertexShader =
-      Fwog::Shader(Fwog::PipelineStage::VERTEX_SHADER, Utility::LoadFile("shaders/FullScreenTri.vert.glsl"));
-  auto fragmentShader = Fwog::Shader(Fwog::PipelineStage::FRAGMENT_SHADER, Utility::LoadFile("shaders/Texture.frag.glsl"));
-
-  return Fwog::GraphicsPipeline({
-      .vertexShader = &vertexShader,
-      .fragmentShader = &fragmentShader,
+  auto vertexShader = shaderCache.GetOrCompile(Fwog::PipelineStage::VERTEX_SHADER,
+                                               Utility::LoadFile("shaders/FullScreenTri.vert.glsl"));
+  auto fragmentShader = shaderCache.GetOrCompile(Fwog::PipelineStage::FRAGMENT_SHADER,
+                                                 Utility::LoadFile("shaders/Texture.frag.glsl"));
+
+  return Fwog::CompileGraphicsPipelineAsync({
+      .vertexShader = vertexShader.get(),
+      .fragmentShader = fragmentShader.get(),
       .rasterizationState = {.cullMode = Fwog::CullMode::NONE},
       .depthState = {.depthTestEnable = false, .depthWriteEnable = false},
   });
 }
 
-Fwog::ComputePipeline CreateCopyToEsmPipeline()
+Fwog::PendingPipeline<Fwog::ComputePipeline> CreateCopyToEsmPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto shader = Fwog::Shader(Fwog::PipelineStage::COMPUTE_SHADER,
-                             Utility::LoadFile("shaders/volumetric/Depth2exponential.comp.glsl"));
+  auto shader = shaderCache.GetOrCompile(Fwog::PipelineStage::COMPUTE_SHADER,
+                                         Utility::LoadFile("shaders/volumetric/Depth2exponential.comp.glsl"));
 
-  return Fwog::ComputePipeline({.shader = &shader});
+  return Fwog::CompileComputePipelineAsync({.shader = shader.get()});
 }
 
-Fwog::ComputePipeline CreateGaussianBlurPipeline()
+Fwog::PendingPipeline<Fwog::ComputePipeline> CreateGaussianBlurPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto shader =
-      Fwog::Shader(Fwog::PipelineStage::COMPUTE_SHADER, Utility::LoadFile("shaders/volumetric/GaussianBlur.comp.glsl"));
+  auto shader = shaderCache.GetOrCompile(Fwog::PipelineStage::COMPUTE_SHADER,
+                                         Utility::LoadFile("shaders/volumetric/GaussianBlur.comp.glsl"));
 
-  return Fwog::ComputePipeline({.shader = &shader});
+  return Fwog::CompileComputePipelineAsync({.shader = shader.get()});
 }
 
-Fwog::ComputePipeline CreatePostprocessingPipeline()
+Fwog::PendingPipeline<Fwog::ComputePipeline> CreatePostprocessingPipeline(Fwog::ShaderCache& shaderCache)
 {
-  auto shader = Fwog::Shader(Fwog::PipelineStage::COMPUTE_SHADER,
-                             Utility::LoadFile("shaders/volumetric/TonemapAndDither.comp.glsl"));
+  auto shader = shaderCache.GetOrCompile(Fwog::PipelineStage::COMPUTE_SHADER,
+                                         Utility::LoadFile("shaders/volumetric/TonemapAndDither.comp.glsl"));
 
-  return Fwog::ComputePipeline({.shader = &shader});
+  return Fwog::CompileComputePipelineAsync({.shader = shader.get()});
 }
 
 void CursorPosCallback([[maybe_unused]] GLFWwindow* window, double currentCursorX, double currentCursorY)
@@ -325,9 +327,12 @@ public:
     free(marchVolume);
     free(accumulateDensity);
 
-    accumulateDensityPipeline = Fwog::ComputePipeline({.shader = &accumulateShader});
-    marchVolumePipeline = Fwog::ComputePipeline({.shader = &marchShader});
-    applyDeferredPipeline = Fwog::ComputePipeline({.shader = &applyShader});
+    auto pendingAccumulateDensity = Fwog::CompileComputePipelineAsync({.shader = &accumulateShader});
+    auto pendingMarchVolume = Fwog::CompileComputePipelineAsync({.shader = &marchShader});
+    auto pendingApplyDeferred = Fwog::CompileComputePipelineAsync({.shader = &applyShader});
+    accumulateDensityPipeline = pendingAccumulateDensity.Wait();
+    marchVolumePipeline = pendingMarchVolume.Wait();
+    applyDeferredPipeline = pendingApplyDeferred.Wait();
 
     // Load the normalized MiePlot generated scattering data.
     // This texture is used if a compile-time switch is set in marchVolume.comp.glsl.
@@ -579,13 +584,25 @@ void RenderScene(std::optional<std::string_view> fileName, float scale, bool bin
   ss.magFilter = Fwog::Filter::LINEAR;
   auto shadowSampler = Fwog::Sampler(ss);
 
-  Fwog::GraphicsPipeline scenePipeline = CreateScenePipeline();
-  Fwog::GraphicsPipeline shadowPipeline = CreateShadowPipeline();
-  Fwog::GraphicsPipeline shadingPipeline = CreateShadingPipeline();
-  Fwog::GraphicsPipeline debugTexturePipeline = CreateDebugTexturePipeline();
-  Fwog::ComputePipeline copyToEsmPipeline = CreateCopyToEsmPipeline();
-  Fwog::ComputePipeline gaussianBlurPipeline = CreateGaussianBlurPipeline();
-  Fwog::ComputePipeline postprocessingPipeline = CreatePostprocessingPipeline();
+  // shaders shared between pipelines are only compiled once
+  Fwog::ShaderCache shaderCache;
+
+  // start linking every pipeline before waiting on any of them, so the driver can link them in parallel
+  auto pendingScenePipeline = CreateScenePipeline(shaderCache);
+  auto pendingShadowPipeline = CreateShadowPipeline(shaderCache);
+  auto pendingShadingPipeline = CreateShadingPipeline(shaderCache);
+  auto pendingDebugTexturePipeline = CreateDebugTexturePipeline(shaderCache);
+  auto pendingCopyToEsmPipeline = CreateCopyToEsmPipeline(shaderCache);
+  auto pendingGaussianBlurPipeline = CreateGaussianBlurPipeline(shaderCache);
+  auto pendingPostprocessingPipeline = CreatePostprocessingPipeline(shaderCache);
+
+  Fwog::GraphicsPipeline scenePipeline = pendingScenePipeline.Wait();
+  Fwog::GraphicsPipeline shadowPipeline = pendingShadowPipeline.Wait();
+  Fwog::GraphicsPipeline shadingPipeline = pendingShadingPipeline.Wait();
+  Fwog::GraphicsPipeline debugTexturePipeline = pendingDebugTexturePipeline.Wait();
+  Fwog::ComputePipeline copyToEsmPipeline = pendingCopyToEsmPipeline.Wait();
+  Fwog::ComputePipeline gaussianBlurPipeline = pendingGaussianBlurPipeline.Wait();
+  Fwog::ComputePipeline postprocessingPipeline = pendingPostprocessingPipeline.Wait();
 
   View camera;
   camera.position = {0, 1.5, 2};
@@ -715,13 +732,13 @@ void RenderScene(std::optional<std::string_view> fileName, float scale, bool bin
     {
       Fwog::RenderAttachment gcolorAttachment{.texture = &gBufferColorTexture,
                                               .clearValue = Fwog::ClearColorValue{.1f, .3f, .5f, 0.0f},
-                                              .clearOnLoad = true};
+                                              .loadOp = Fwog::AttachmentLoadOp::CLEAR};
       Fwog::RenderAttachment gnormalAttachment{.texture = &gBufferNormalTexture,
                                                .clearValue = Fwog::ClearColorValue{0.f, 0.f, 0.f, 0.f},
-                                               .clearOnLoad = false};
+                                               .loadOp = Fwog::AttachmentLoadOp::DONT_CARE};
       Fwog::RenderAttachment gdepthAttachment{.texture = &gBufferDepthTexture,
                                               .clearValue = Fwog::ClearDepthStencilValue{.depth = 0.0f},
-                                              .clearOnLoad = true};
+                                              .loadOp = Fwog::AttachmentLoadOp::CLEAR};
       Fwog::RenderAttachment cgAttachments[] = {gcolorAttachment, gnormalAttachment};
       Fwog::RenderInfo gbufferRenderInfo{.colorAttachments = cgAttachments,
                                          .depthAttachment = &gdepthAttachment,
@@ -756,7 +773,7 @@ void RenderScene(std::optional<std::string_view> fileName, float scale, bool bin
     {
       Fwog::RenderAttachment depthAttachment{.texture = &shadowDepthTexture,
                                              .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-                                             .clearOnLoad = true};
+                                             .loadOp = Fwog::AttachmentLoadOp::CLEAR};
 
       Fwog::RenderInfo shadowRenderInfo{.depthAttachment = &depthAttachment, .stencilAttachment = nullptr};
       Fwog::BeginRendering(shadowRenderInfo);
@@ -847,7 +864,8 @@ void RenderScene(std::optional<std::string_view> fileName, float scale, bool bin
 
     // shading pass (full screen tri)
     {
-      Fwog::RenderAttachment shadingAttachment{.texture = &shadingTex, .clearOnLoad = false};
+      Fwog::RenderAttachment shadingAttachment{.texture = &shadingTex,
+                                               .loadOp = Fwog::AttachmentLoadOp::DONT_CARE};
 
       Fwog::RenderInfo shadingRenderingInfo{.colorAttachments = {&shadingAttachment, 1}};
       Fwog::BeginRendering(shadingRenderingInfo);
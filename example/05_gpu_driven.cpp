@@ -10,6 +10,7 @@
 #include <string>
 #include <vector>
 
+#include <Fwog/BindGroup.h>
 #include <Fwog/Buffer.h>
 #include <Fwog/DebugMarker.h>
 #include <Fwog/Pipeline.h>
@@ -219,6 +220,9 @@ private:
   std::optional<Fwog::TypedBuffer<BoundingBox>> boundingBoxesBuffer;
   std::optional<Fwog::Buffer> objectIndicesBuffer; // Unused
   std::optional<Fwog::TypedBuffer<Utility::GpuMaterialBindless>> materialsBuffer;
+
+  // The buffers used by the scene pass, which are bound with one call.
+  std::optional<Fwog::BindGroup> sceneBindGroup;
 };
 
 GpuDrivenApplication::GpuDrivenApplication(const Application::CreateInfo& createInfo,
@@ -282,6 +286,20 @@ GpuDrivenApplication::GpuDrivenApplication(const Application::CreateInfo& create
   objectIndicesBuffer = Fwog::Buffer(std::span(objectIndices));
   materialsBuffer = Fwog::TypedBuffer<Utility::GpuMaterialBindless>(scene.materials);
 
+  const Fwog::BindGroupBuffer sceneUniformBuffers[] = {
+    {.index = 0, .buffer = &globalUniformsBuffer},
+  };
+  const Fwog::BindGroupBuffer sceneStorageBuffers[] = {
+    {.index = 0, .buffer = &meshUniformBuffer.value()},
+    {.index = 1, .buffer = &materialsBuffer.value()},
+    {.index = 2, .buffer = &boundingBoxesBuffer.value()},
+    {.index = 3, .buffer = &objectIndicesBuffer.value()},
+  };
+  sceneBindGroup = Fwog::BindGroup({
+    .uniformBuffers = sceneUniformBuffers,
+    .storageBuffers = sceneStorageBuffers,
+  });
+
   mainCamera.position = {0, 1.5, 2};
   mainCamera.yaw = -glm::half_pi<float>();
 
@@ -312,7 +330,7 @@ void GpuDrivenApplication::OnRender([[maybe_unused]] double dt)
   Fwog::RenderAttachment gDepthAttachment{
     .texture = &frame.gDepth.value(),
     .clearValue = Fwog::ClearDepthStencilValue{.depth = 1.0f},
-    .clearOnLoad = true,
+    .loadOp = Fwog::AttachmentLoadOp::CLEAR,
   };
 
   // Scene pass. Draw everything that was marked visible in the previous frame's culling pass.
@@ -320,7 +338,7 @@ void GpuDrivenApplication::OnRender([[maybe_unused]] double dt)
     Fwog::RenderAttachment gColorAttachment{
       .texture = &frame.gAlbedo.value(),
       .clearValue = Fwog::ClearColorValue{.1f, .3f, .5f, 0.0f},
-      .clearOnLoad = true,
+      .loadOp = Fwog::AttachmentLoadOp::CLEAR,
     };
     Fwog::BeginRendering({
       .name = "Scene",
@@ -332,11 +350,7 @@ void GpuDrivenApplication::OnRender([[maybe_unused]] double dt)
     Fwog::Cmd::MemoryBarrier(Fwog::MemoryBarrierAccessBit::COMMAND_BUFFER_BIT |
                              Fwog::MemoryBarrierAccessBit::SHADER_STORAGE_BIT);
 
-    Fwog::Cmd::BindUniformBuffer(0, globalUniformsBuffer, 0, globalUniformsBuffer.Size());
-    Fwog::Cmd::BindStorageBuffer(0, meshUniformBuffer.value(), 0, meshUniformBuffer->Size());
-    Fwog::Cmd::BindStorageBuffer(1, materialsBuffer.value(), 0, materialsBuffer->Size());
-    Fwog::Cmd::BindStorageBuffer(2, boundingBoxesBuffer.value(), 0, boundingBoxesBuffer->Size());
-    Fwog::Cmd::BindStorageBuffer(3, objectIndicesBuffer.value(), 0, objectIndicesBuffer->Size());
+    Fwog::Cmd::BindGroup(sceneBindGroup.value());
 
     Fwog::Cmd::BindGraphicsPipeline(scenePipeline);
     Fwog::Cmd::BindVertexBuffer(0, vertexBuffer.value(), 0, sizeof(Utility::Vertex));
@@ -358,7 +372,7 @@ void GpuDrivenApplication::OnRender([[maybe_unused]] double dt)
   // noticeable unless at low framerates.
   if (!config.freezeCulling)
   {
-    gDepthAttachment.clearOnLoad = false;
+    gDepthAttachment.loadOp = Fwog::AttachmentLoadOp::LOAD;
     Fwog::BeginRendering({.name = "Occlusion culling", .depthAttachment = &gDepthAttachment});
 
     // Re-upload the draw commands buffer to reset the instance counts to 0 for culling.
@@ -184,6 +184,10 @@ Application::Application(const CreateInfo& createInfo)
   glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
   glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0, nullptr, GL_TRUE);
 
+  // Reuse program binaries from previous runs.
+  pipelineCache.emplace("pipeline_cache.bin");
+  Fwog::SetPipelineCache(&*pipelineCache);
+
   // Initialize ImGui and a backend for it.
   // Because we allow the GLFW backend to install callbacks, it will automatically call our own that we provided.
   ImGui::CreateContext();
@@ -194,6 +198,9 @@ Application::Application(const CreateInfo& createInfo)
 
 Application::~Application()
 {
+  pipelineCache->Save();
+  pipelineCache.reset();
+
   ImGui_ImplOpenGL3_Shutdown();
   ImGui_ImplGlfw_Shutdown();
   ImGui::DestroyContext();
@@ -2,9 +2,12 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 
+#include <optional>
 #include <string_view>
 #include <string>
 
+#include <Fwog/PipelineCache.h>
+
 #include <glm/gtx/transform.hpp>
 #include <glm/vec3.hpp>
 #include <glm/vec2.hpp>
@@ -74,4 +77,5 @@ private:
   glm::dvec2 cursorFrameOffset{};
   bool cursorJustEnteredWindow = true;
   bool graveHeldLastFrame = false;
+  std::optional<Fwog::PipelineCache> pipelineCache;
 };
\ No newline at end of file
@@ -4,13 +4,11 @@
 #include <Fwog/DebugMarker.h>
 #include <Fwog/Rendering.h>
 #include <Fwog/Shader.h>
+#include <Fwog/ShaderSourceLoader.h>
 
 #include <imgui.h>
 
 #include <stb_image.h>
-#define STB_INCLUDE_IMPLEMENTATION
-#define STB_INCLUDE_LINE_GLSL
-#include <stb_include.h>
 
 #include <memory>
 #include <utility>
@@ -41,11 +39,9 @@ static float rng(glm::uint& state)
 
 static std::string LoadFileWithInclude(std::string_view path)
 {
-  char error[256] = {};
-  char* included = stb_include_string(Application::LoadFile(path).data(), nullptr, "shaders/rsm", "", error);
-  std::string includedStr = included;
-  free(included);
-  return includedStr;
+  // shared so the common headers are only read once, even when the technique is recreated after a resize
+  static Fwog::ShaderSourceLoader loader;
+  return loader.Load(path).source;
 }
 
 static Fwog::ComputePipeline CreateRsmIndirectPipeline()
@@ -256,15 +252,32 @@ namespace RSM
     {
       Fwog::ScopedDebugMarker marker("Indirect Illumination");
 
-      Fwog::Cmd::BindSampledImage(0, indirectUnfilteredTex, nearestSampler);
-      Fwog::Cmd::BindSampledImage(1, gAlbedo, nearestSampler);
-      Fwog::Cmd::BindSampledImage(2, gNormalSmall ? gNormalSmall.value() : gNormal, nearestSampler);
-      Fwog::Cmd::BindSampledImage(3, gDepthSmall ? gDepthSmall.value() : gDepth, nearestSampler);
-      Fwog::Cmd::BindSampledImage(4, rsmFluxSmall, nearestSamplerClamped);
-      Fwog::Cmd::BindSampledImage(5, rsmNormalSmall, nearestSampler);
-      Fwog::Cmd::BindSampledImage(6, rsmDepthSmall, nearestSampler);
-      Fwog::Cmd::BindUniformBuffer(0, cameraUniformBuffer, 0, cameraUniformBuffer.Size());
-      Fwog::Cmd::BindUniformBuffer(1, rsmUniformBuffer, 0, rsmUniformBuffer.Size());
+      const Fwog::BindGroupSampledImage sampledImages[] = {
+        {.index = 0, .texture = &indirectUnfilteredTex, .sampler = nearestSampler},
+        {.index = 1, .texture = &gAlbedo, .sampler = nearestSampler},
+        {.index = 2, .texture = gNormalSmall ? &gNormalSmall.value() : &gNormal, .sampler = nearestSampler},
+        {.index = 3, .texture = gDepthSmall ? &gDepthSmall.value() : &gDepth, .sampler = nearestSampler},
+        {.index = 4, .texture = &rsmFluxSmall, .sampler = nearestSamplerClamped},
+        {.index = 5, .texture = &rsmNormalSmall, .sampler = nearestSampler},
+        {.index = 6, .texture = &rsmDepthSmall, .sampler = nearestSampler},
+      };
+      std::array<uint32_t, std::size(sampledImages)> textures{};
+      for (size_t i = 0; i < textures.size(); i++)
+      {
+        textures[i] = sampledImages[i].texture->Handle();
+      }
+
+      if (!indirectBindGroup || textures != indirectBindGroupTextures)
+      {
+        const Fwog::BindGroupBuffer uniformBuffers[] = {
+          {.index = 0, .buffer = &cameraUniformBuffer},
+          {.index = 1, .buffer = &rsmUniformBuffer},
+        };
+        indirectBindGroup.emplace(
+          Fwog::BindGroupInfo{.uniformBuffers = uniformBuffers, .sampledImages = sampledImages});
+        indirectBindGroupTextures = textures;
+      }
+      Fwog::Cmd::BindGroup(*indirectBindGroup);
 
       if (rsmFiltered)
       {
@@ -1,4 +1,5 @@
 #pragma once
+#include <Fwog/BindGroup.h>
 #include <Fwog/Buffer.h>
 #include <Fwog/Pipeline.h>
 #include <Fwog/Texture.h>
@@ -6,6 +7,7 @@
 #include <glm/mat4x4.hpp>
 #include <glm/vec2.hpp>
 
+#include <array>
 #include <optional>
 
 namespace RSM
@@ -137,5 +139,9 @@ namespace RSM
     std::optional<Fwog::Texture> gDepthSmall;
     std::optional<Fwog::Texture> gNormalPrevSmall;
     std::optional<Fwog::Texture> gDepthPrevSmall;
+
+    // rebuilt when any of the textures it binds is recreated
+    std::optional<Fwog::BindGroup> indirectBindGroup;
+    std::array<uint32_t, 7> indirectBindGroupTextures{};
   };
 } // namespace RSM
\ No newline at end of file
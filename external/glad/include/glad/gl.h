@@ -3,7 +3,7 @@
  *
  * Generator: C/C++
  * Specification: gl
- * Extensions: 1
+ * Extensions: 2
  *
  * APIs:
  *  - gl:core=4.6
@@ -18,10 +18,10 @@
  *  - ON_DEMAND = False
  *
  * Commandline:
- *    --api='gl:core=4.6' --extensions='GL_ARB_bindless_texture' c
+ *    --api='gl:core=4.6' --extensions='GL_ARB_bindless_texture,GL_KHR_parallel_shader_compile' c
  *
  * Online:
- *    http://glad.sh/#api=gl%3Acore%3D4.6&extensions=GL_ARB_bindless_texture&generator=c&options=
+ *    http://glad.sh/#api=gl%3Acore%3D4.6&extensions=GL_ARB_bindless_texture%2CGL_KHR_parallel_shader_compile&generator=c&options=
  *
  */
 
@@ -327,6 +327,7 @@ typedef void (*GLADpostcallback)(void *ret, const char *name, GLADapiproc apipro
 #define GL_COMPARE_REF_TO_TEXTURE 0x884E
 #define GL_COMPATIBLE_SUBROUTINES 0x8E4B
 #define GL_COMPILE_STATUS 0x8B81
+#define GL_COMPLETION_STATUS_KHR 0x91B1
 #define GL_COMPRESSED_R11_EAC 0x9270
 #define GL_COMPRESSED_RED 0x8225
 #define GL_COMPRESSED_RED_RGTC1 0x8DBB
@@ -804,6 +805,7 @@ typedef void (*GLADpostcallback)(void *ret, const char *name, GLADapiproc apipro
 #define GL_MAX_SAMPLES 0x8D57
 #define GL_MAX_SAMPLE_MASK_WORDS 0x8E59
 #define GL_MAX_SERVER_WAIT_TIMEOUT 0x9111
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
 #define GL_MAX_SHADER_STORAGE_BLOCK_SIZE 0x90DE
 #define GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS 0x90DD
 #define GL_MAX_SUBROUTINES 0x8DE7
@@ -1647,6 +1649,8 @@ GLAD_API_CALL int GLAD_GL_VERSION_4_5;
 GLAD_API_CALL int GLAD_GL_VERSION_4_6;
 #define GL_ARB_bindless_texture 1
 GLAD_API_CALL int GLAD_GL_ARB_bindless_texture;
+#define GL_KHR_parallel_shader_compile 1
+GLAD_API_CALL int GLAD_GL_KHR_parallel_shader_compile;
 
 
 typedef void (GLAD_API_PTR *PFNGLACTIVESHADERPROGRAMPROC)(GLuint pipeline, GLuint program);
@@ -1999,6 +2003,7 @@ typedef void * (GLAD_API_PTR *PFNGLMAPBUFFERPROC)(GLenum target, GLenum access);
 typedef void * (GLAD_API_PTR *PFNGLMAPBUFFERRANGEPROC)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
 typedef void * (GLAD_API_PTR *PFNGLMAPNAMEDBUFFERPROC)(GLuint buffer, GLenum access);
 typedef void * (GLAD_API_PTR *PFNGLMAPNAMEDBUFFERRANGEPROC)(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access);
+typedef void (GLAD_API_PTR *PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
 typedef void (GLAD_API_PTR *PFNGLMEMORYBARRIERPROC)(GLbitfield barriers);
 typedef void (GLAD_API_PTR *PFNGLMEMORYBARRIERBYREGIONPROC)(GLbitfield barriers);
 typedef void (GLAD_API_PTR *PFNGLMINSAMPLESHADINGPROC)(GLfloat value);
@@ -3023,6 +3028,8 @@ GLAD_API_CALL PFNGLMAPNAMEDBUFFERPROC glad_glMapNamedBuffer;
 #define glMapNamedBuffer glad_glMapNamedBuffer
 GLAD_API_CALL PFNGLMAPNAMEDBUFFERRANGEPROC glad_glMapNamedBufferRange;
 #define glMapNamedBufferRange glad_glMapNamedBufferRange
+GLAD_API_CALL PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glad_glMaxShaderCompilerThreadsKHR;
+#define glMaxShaderCompilerThreadsKHR glad_glMaxShaderCompilerThreadsKHR
 GLAD_API_CALL PFNGLMEMORYBARRIERPROC glad_glMemoryBarrier;
 #define glMemoryBarrier glad_glMemoryBarrier
 GLAD_API_CALL PFNGLMEMORYBARRIERBYREGIONPROC glad_glMemoryBarrierByRegion;
@@ -96,6 +96,10 @@ namespace Fwog
     bool operator==(const Rect2D&) const noexcept = default;
   };
 
+  // Buffer binding size that extends to the end of the buffer. Uniform buffer bindings are further limited to the
+  // size of the block declared at that index by the pipeline used in the draw or dispatch.
+  constexpr uint64_t WHOLE_BUFFER = static_cast<uint64_t>(-1);
+
   enum class ImageType : uint32_t
   {
     TEX_1D,
@@ -425,6 +429,21 @@ namespace Fwog
     DECREMENT_AND_WRAP  = 7,
   };
 
+  // what happens to an attachment's contents at the start of a rendering scope
+  enum class AttachmentLoadOp : uint32_t
+  {
+    LOAD,      // keep the previous contents
+    CLEAR,     // clear to the attachment's clear value
+    DONT_CARE, // the previous contents are undefined, so the driver does not need to load them
+  };
+
+  // what happens to an attachment's contents at the end of a rendering scope
+  enum class AttachmentStoreOp : uint32_t
+  {
+    STORE,     // keep the rendered contents
+    DONT_CARE, // the contents are undefined afterwards, so the driver does not need to store them
+  };
+
   struct DrawIndirectCommand
   {
     uint32_t vertexCount;
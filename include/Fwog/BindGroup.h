@@ -0,0 +1,100 @@
+#pragma once
+#include <Fwog/BasicTypes.h>
+#include <Fwog/Texture.h>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  namespace detail
+  {
+    class BindingStateTracker;
+  }
+
+  class Buffer;
+
+  struct BindGroupBuffer
+  {
+    uint32_t index;
+    const Buffer* buffer;
+    uint64_t offset = 0;
+    uint64_t size = WHOLE_BUFFER; // the rest of the buffer
+  };
+
+  struct BindGroupSampledImage
+  {
+    uint32_t index;
+    const Texture* texture;
+    Sampler sampler;
+  };
+
+  struct BindGroupImage
+  {
+    uint32_t index;
+    const Texture* texture;
+    uint32_t level = 0;
+  };
+
+  struct BindGroupInfo
+  {
+    std::span<const BindGroupBuffer> uniformBuffers;
+    std::span<const BindGroupBuffer> storageBuffers;
+    std::span<const BindGroupSampledImage> sampledImages;
+    std::span<const BindGroupImage> images;
+  };
+
+  // An immutable set of resource bindings that is bound with Cmd::BindGroup.
+  // The names, ranges and formats of the bindings are resolved once at creation, so binding a group only copies them
+  // into the shadowed binding state, where they are submitted at the next draw or dispatch with one multi-bind call per
+  // resource class. Binding a group that is identical to the last group bound, with no binds in between, does nothing.
+  // Slots that are not in the group keep their bindings. The resources must outlive the group.
+  class BindGroup
+  {
+  public:
+    explicit BindGroup(const BindGroupInfo& info);
+
+    // hash of the resolved bindings; equal groups have equal hashes
+    [[nodiscard]] uint64_t Hash() const
+    {
+      return hash_;
+    }
+
+  private:
+    friend class detail::BindingStateTracker;
+
+    // entries are sorted by slot, and bit i of mask is set if slot i is in the group
+    struct Buffers
+    {
+      uint32_t mask{};
+      uint32_t wholeBuffer{}; // bit i is set if slot i was given WHOLE_BUFFER
+      std::vector<uint32_t> names;
+      std::vector<int64_t> offsets;
+      std::vector<int64_t> sizes;
+    };
+
+    struct SampledImages
+    {
+      uint32_t mask{};
+      std::vector<uint32_t> textures;
+      std::vector<uint32_t> samplers;
+    };
+
+    struct Images
+    {
+      uint32_t mask{};
+      std::vector<uint32_t> textures;
+      std::vector<int32_t> levels;
+      std::vector<uint32_t> formats;
+    };
+
+    Buffers uniformBuffers_;
+    Buffers storageBuffers_;
+    SampledImages sampledImages_;
+    Images images_;
+    uint64_t hash_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
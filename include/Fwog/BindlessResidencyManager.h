@@ -0,0 +1,95 @@
+#pragma once
+#include <Fwog/Buffer.h>
+#include <Fwog/Texture.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  namespace detail
+  {
+    // called when a texture is destroyed, since its handles are destroyed with it
+    void RemoveTextureFromResidencyManagers(uint32_t texture);
+  }
+
+  // Owns the bindless handles of (texture, sampler) pairs, and publishes them in a table in a storage buffer that
+  // shaders index with the value returned by Reference.
+  // Handles stay resident while the textures they refer to fit in the budget. Past it, Update makes the least recently
+  // referenced handles non-resident. A handle is made resident again when it is referenced, so every handle a frame
+  // samples must be referenced before that frame's Update.
+  // A pair's handle must not also be obtained with Texture::GetBindlessHandle, as both would manage its residency.
+  class BindlessResidencyManager
+  {
+  public:
+    // capacity is the number of entries in the handle table, and residentBudgetBytes is the estimated size of the
+    // textures that are kept resident
+    BindlessResidencyManager(uint32_t capacity, uint64_t residentBudgetBytes);
+    ~BindlessResidencyManager();
+    BindlessResidencyManager(const BindlessResidencyManager&) = delete;
+    BindlessResidencyManager& operator=(const BindlessResidencyManager&) = delete;
+
+    // Returns the pair's index in the handle table, creating its handle and making it resident if needed.
+    // The index stays the same until the texture is destroyed.
+    [[nodiscard]] uint32_t Reference(const Texture& texture, const Sampler& sampler);
+
+    // Makes handles that were not referenced since the last update non-resident, least recently referenced first, until
+    // the resident textures fit in the budget. Then uploads the table entries that changed.
+    void Update();
+
+    // An array of uint64_t handles. Entries of destroyed textures are zero.
+    [[nodiscard]] const Buffer& HandleTable() const
+    {
+      return handleTable_;
+    }
+
+    [[nodiscard]] uint64_t ResidentBytes() const
+    {
+      return residentBytes_;
+    }
+
+    [[nodiscard]] uint32_t ResidentHandleCount() const
+    {
+      return residentHandleCount_;
+    }
+
+    // number of times a handle was made non-resident to stay within the budget
+    [[nodiscard]] uint32_t Evictions() const
+    {
+      return evictions_;
+    }
+
+  private:
+    friend void detail::RemoveTextureFromResidencyManagers(uint32_t texture);
+
+    struct Entry
+    {
+      uint64_t key;            // texture << 32 | sampler, or 0 if the entry is free
+      uint64_t handle;
+      uint64_t bytes;          // estimated size of the texture
+      uint64_t lastReferenced; // update count when the handle was last referenced
+      bool resident;
+    };
+
+    void MakeResident(Entry& entry);
+    void MakeNonResident(Entry& entry);
+    void SetTableEntry(uint32_t index, uint64_t handle);
+    void RemoveTexture(uint32_t texture);
+
+    std::vector<Entry> entries_; // indexed like the handle table
+    std::vector<uint32_t> freeIndices_;
+    std::unordered_map<uint64_t, uint32_t> indices_;
+    std::vector<uint64_t> handles_; // contents of the handle table
+    uint32_t dirtyBegin_;
+    uint32_t dirtyEnd_{};
+    Buffer handleTable_;
+    uint64_t residentBudgetBytes_;
+    uint64_t residentBytes_{};
+    uint64_t updateCount_{};
+    uint32_t residentHandleCount_{};
+    uint32_t evictions_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
@@ -46,6 +46,12 @@ namespace Fwog
     MAP_WRITE = 1 << 1,
     MAP_PERSISTENT = 1 << 2,
     MAP_COHERENT = 1 << 3,
+
+    // only valid when mapping, not when creating a buffer
+    MAP_INVALIDATE_RANGE = 1 << 4,  // the previous contents of the mapped range may be discarded
+    MAP_INVALIDATE_BUFFER = 1 << 5, // the previous contents of the whole buffer may be discarded
+    MAP_FLUSH_EXPLICIT = 1 << 6,    // writes are only visible to the GPU once flushed with FlushMappedRange
+    MAP_UNSYNCHRONIZED = 1 << 7,    // does not wait for pending GPU reads and writes of the buffer
   };
   FWOG_DECLARE_FLAG_TYPE(BufferMapFlags, BufferMapFlag, uint32_t)
 
@@ -73,8 +79,15 @@ namespace Fwog
                       UploadType uploadType,
                       const void* data) const;
 
-    // TODO: add range and read/write flags
+    // maps the whole buffer
     [[nodiscard]] void* Map(BufferMapFlags flags) const;
+
+    // Maps size bytes starting at offset. Only one range of a buffer can be mapped at a time.
+    [[nodiscard]] void* MapRange(size_t offset, size_t size, BufferMapFlags flags) const;
+
+    // Makes writes to part of a range mapped with MAP_FLUSH_EXPLICIT visible to the GPU.
+    // offset is relative to the start of the mapped range.
+    void FlushMappedRange(size_t offset, size_t size) const;
     void Unmap() const;
 
     [[nodiscard]] auto Handle() const
@@ -99,6 +112,8 @@ namespace Fwog
     size_t size_{};
     uint32_t id_{};
     mutable bool isMapped_{false};
+    mutable size_t mappedSize_{};
+    mutable BufferMapFlags mappedFlags_{};
   };
 
   template<class T>
@@ -149,6 +164,17 @@ namespace Fwog
       return reinterpret_cast<T*>(Buffer::Map(flags));
     }
 
+    [[nodiscard]] T* MapRangeTyped(size_t first, size_t count, BufferMapFlags flags) const
+    {
+      return reinterpret_cast<T*>(Buffer::MapRange(sizeof(T) * first, sizeof(T) * count, flags));
+    }
+
+    // first is relative to the first mapped element
+    void FlushMappedRangeTyped(size_t first, size_t count) const
+    {
+      Buffer::FlushMappedRange(sizeof(T) * first, sizeof(T) * count);
+    }
+
   private:
   };
 
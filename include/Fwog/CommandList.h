@@ -0,0 +1,127 @@
+#pragma once
+#include <Fwog/BasicTypes.h>
+#include <Fwog/Rendering.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  class Buffer;
+  class Texture;
+  class Sampler;
+  class BindGroup;
+  struct GraphicsPipeline;
+  struct ComputePipeline;
+
+  namespace detail
+  {
+    enum class CommandType : uint32_t;
+  }
+
+  // A deferred list of commands stored in a compact linear byte stream.
+  // Recording a command list does not touch OpenGL or any global rendering state, so lists can be recorded on any
+  // thread. Recorded lists are executed on the thread that owns the context with ExecuteCommandLists.
+  // Objects referenced by a command list (pipelines, buffers, textures) must outlive the execution of the list.
+  class CommandList
+  {
+  public:
+    CommandList() = default;
+    CommandList(CommandList&& old) noexcept = default;
+    CommandList& operator=(CommandList&& old) noexcept = default;
+    CommandList(const CommandList&) = delete;
+    CommandList& operator=(const CommandList&) = delete;
+
+    // scopes (see Rendering.h)
+    void BeginSwapchainRendering(const SwapchainRenderInfo& renderInfo);
+    void BeginRendering(const RenderInfo& renderInfo);
+    void EndRendering();
+    void BeginCompute(std::string_view name = {});
+    void EndCompute();
+
+    // commands (see Fwog::Cmd)
+    void BindGraphicsPipeline(const GraphicsPipeline& pipeline);
+    void BindComputePipeline(const ComputePipeline& pipeline);
+    void SetViewport(const Viewport& viewport);
+    void SetViewports(std::span<const Viewport> viewports, uint32_t firstViewport = 0);
+    void SetScissor(const Rect2D& scissor);
+    void SetScissors(std::span<const Rect2D> scissors, uint32_t firstScissor = 0);
+    void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance);
+    void DrawIndexed(uint32_t indexCount,
+                     uint32_t instanceCount,
+                     uint32_t firstIndex,
+                     int32_t vertexOffset,
+                     uint32_t firstInstance);
+    void DrawIndirect(const Buffer& commandBuffer, uint64_t commandBufferOffset, uint32_t drawCount, uint32_t stride);
+    void DrawIndirectCount(const Buffer& commandBuffer,
+                           uint64_t commandBufferOffset,
+                           const Buffer& countBuffer,
+                           uint64_t countBufferOffset,
+                           uint32_t maxDrawCount,
+                           uint32_t stride);
+    void DrawIndexedIndirect(const Buffer& commandBuffer,
+                             uint64_t commandBufferOffset,
+                             uint32_t drawCount,
+                             uint32_t stride);
+    void DrawIndexedIndirectCount(const Buffer& commandBuffer,
+                                  uint64_t commandBufferOffset,
+                                  const Buffer& countBuffer,
+                                  uint64_t countBufferOffset,
+                                  uint32_t maxDrawCount,
+                                  uint32_t stride);
+    void BindVertexBuffer(uint32_t bindingIndex, const Buffer& buffer, uint64_t offset, uint64_t stride);
+    void BindIndexBuffer(const Buffer& buffer, IndexType indexType);
+    void BindUniformBuffer(uint32_t index, const Buffer& buffer, uint64_t offset = 0, uint64_t size = WHOLE_BUFFER);
+    void BindStorageBuffer(uint32_t index, const Buffer& buffer, uint64_t offset = 0, uint64_t size = WHOLE_BUFFER);
+    void BindSampledImage(uint32_t index, const Texture& texture, const Sampler& sampler);
+    void BindImage(uint32_t index, const Texture& texture, uint32_t level);
+    void BindGroup(const Fwog::BindGroup& group);
+    void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
+    void DispatchIndirect(const Buffer& commandBuffer, uint64_t commandBufferOffset);
+    void MemoryBarrier(MemoryBarrierAccessBits accessBits);
+
+    // removes all recorded commands, but keeps the allocated memory for reuse
+    void Reset();
+
+    [[nodiscard]] bool Empty() const
+    {
+      return data_.empty();
+    }
+
+    [[nodiscard]] size_t CommandCount() const
+    {
+      return commandCount_;
+    }
+
+    [[nodiscard]] size_t SizeBytes() const
+    {
+      return data_.size();
+    }
+
+  private:
+    friend void ExecuteCommandLists(std::span<const CommandList* const> commandLists);
+
+    // reserves space for a command and its payload, returning a pointer to the payload
+    std::byte* Allocate(detail::CommandType type, size_t payloadSize);
+    template<typename T>
+    void Push(detail::CommandType type, const T& command);
+    void Execute() const;
+
+    std::vector<std::byte> data_;
+    size_t commandCount_{};
+  };
+
+  // Executes each command list in order. Must be called on the thread that owns the context.
+  void ExecuteCommandLists(std::span<const CommandList* const> commandLists);
+
+  inline void ExecuteCommandList(const CommandList& commandList)
+  {
+    const CommandList* list = &commandList;
+    ExecuteCommandLists({&list, 1});
+  }
+
+  // clang-format on
+} // namespace Fwog
@@ -0,0 +1,124 @@
+#pragma once
+#include <Fwog/BasicTypes.h>
+#include <Fwog/Texture.h>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  class Buffer;
+  struct GraphicsPipeline;
+
+  struct DrawTextureBinding
+  {
+    uint32_t index;         // texture unit
+    const Texture* texture;
+    Sampler sampler;
+  };
+
+  // A single draw, along with all the state it needs.
+  // If indexBuffer is null, the draw is non-indexed and uses firstVertex instead of firstIndex and vertexOffset.
+  struct DrawItem
+  {
+    const GraphicsPipeline* pipeline = nullptr;
+    const Buffer* vertexBuffer       = nullptr; // bound to binding 0
+    uint64_t vertexBufferOffset      = 0;
+    uint64_t vertexStride            = 0;
+    const Buffer* indexBuffer        = nullptr;
+    IndexType indexType              = IndexType::UNSIGNED_INT;
+    std::span<const DrawTextureBinding> textures = {}; // copied on submission
+    float depth                      = 0;             // non-negative view depth, draws are sorted front-to-back
+
+    uint32_t count         = 0; // index or vertex count
+    uint32_t instanceCount = 1;
+    uint32_t firstIndex    = 0;
+    uint32_t firstVertex   = 0;
+    int32_t vertexOffset   = 0;
+    uint32_t firstInstance = 0;
+  };
+
+  // The number of state changes a flush issued, and the number it would have issued in submission order
+  struct DrawBucketStats
+  {
+    uint32_t drawCount = 0;
+    uint32_t pipelineChanges = 0;
+    uint32_t geometryChanges = 0;
+    uint32_t textureChanges = 0;
+    uint32_t unsortedPipelineChanges = 0;
+    uint32_t unsortedGeometryChanges = 0;
+    uint32_t unsortedTextureChanges = 0;
+
+    [[nodiscard]] uint32_t StateChanges() const
+    {
+      return pipelineChanges + geometryChanges + textureChanges;
+    }
+
+    [[nodiscard]] uint32_t UnsortedStateChanges() const
+    {
+      return unsortedPipelineChanges + unsortedGeometryChanges + unsortedTextureChanges;
+    }
+
+    // negative if sorting issued more state changes than submission order would have
+    [[nodiscard]] int64_t StateChangesSaved() const
+    {
+      return int64_t(UnsortedStateChanges()) - int64_t(StateChanges());
+    }
+  };
+
+  // Collects a frame's draws, then sorts them by a 64-bit key before issuing them so that draws sharing a pipeline,
+  // texture set, and geometry are adjacent. The key is, from most to least significant bits:
+  // pipeline (12) | texture set (18) | vertex + index buffers (18) | depth bucket (16).
+  // Objects referenced by submitted draws must stay alive until the bucket is flushed.
+  class DrawBucket
+  {
+  public:
+    void Submit(const DrawItem& draw);
+
+    // Sorts and issues all submitted draws, then clears the bucket. Must be called in a rendering scope.
+    DrawBucketStats Flush();
+
+    void Clear();
+
+    [[nodiscard]] size_t Size() const
+    {
+      return draws_.size();
+    }
+
+  private:
+    struct Draw
+    {
+      DrawItem item;       // textures span is not used after submission
+      uint32_t firstTexture;
+      uint32_t textureCount;
+      uint64_t geometryHash;
+      uint64_t textureSetHash;
+    };
+
+    struct StateChangeCounts
+    {
+      uint32_t pipeline;
+      uint32_t geometry;
+      uint32_t texture;
+    };
+
+    void SortKeys();
+
+    // walks the draws in the given order, counting state changes and issuing the commands if execute is true
+    StateChangeCounts Issue(std::span<const uint32_t> order, bool execute) const;
+
+    std::vector<Draw> draws_;
+    std::vector<DrawTextureBinding> textures_;
+    std::vector<uint64_t> keys_;
+    std::vector<uint32_t> order_;
+    std::vector<uint64_t> scratchKeys_;
+    std::vector<uint32_t> scratchOrder_;
+    std::unordered_map<uint64_t, uint32_t> pipelineIds_;
+    std::unordered_map<uint64_t, uint32_t> geometryIds_;
+    std::unordered_map<uint64_t, uint32_t> textureSetIds_;
+  };
+
+  // clang-format on
+} // namespace Fwog
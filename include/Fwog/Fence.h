@@ -22,6 +22,10 @@ namespace Fwog
     // TODO: add timeout
     uint64_t Wait();
 
+    // Blocks until the fence is signaled without timing the wait, so it does not wait for later GPU work.
+    // Returns immediately if the fence is already signaled.
+    void WaitUntilSignaled();
+
   private:
     void* sync_{};
   };
@@ -0,0 +1,106 @@
+#pragma once
+#include <Fwog/BasicTypes.h>
+#include <Fwog/Buffer.h>
+#include <Fwog/detail/OffsetAllocator.h>
+#include <Fwog/detail/SlotMap.h>
+#include <cstdint>
+#include <optional>
+
+namespace Fwog
+{
+  // clang-format off
+  struct GeometryHeapCreateInfo
+  {
+    uint32_t vertexStride;   // size of a vertex in bytes
+    uint32_t vertexCapacity; // number of vertices the heap can hold
+    uint32_t indexCapacity;
+    IndexType indexType = IndexType::UNSIGNED_INT;
+  };
+
+  // Where an allocation's geometry is in the heap. The members are the ones Cmd::DrawIndexed and
+  // DrawIndexedIndirectCommand take.
+  struct GeometryRange
+  {
+    int32_t vertexOffset; // base vertex
+    uint32_t vertexCount;
+    uint32_t firstIndex;
+    uint32_t indexCount;
+  };
+
+  // Sub-allocates the vertices and indices of many meshes from one vertex buffer and one index buffer, so they can all
+  // be drawn with the same vertex and index buffer bindings and merged into multi-draw calls.
+  // Indices are relative to their mesh's first vertex, and are drawn with the range's vertexOffset as the base vertex.
+  // Free space is tracked with a TLSF allocator, so allocating and freeing take constant time. Allocations fail when
+  // the free space is too fragmented, which Defragment fixes.
+  class GeometryHeap
+  {
+  public:
+    explicit GeometryHeap(const GeometryHeapCreateInfo& createInfo);
+    GeometryHeap(const GeometryHeap&) = delete;
+    GeometryHeap& operator=(const GeometryHeap&) = delete;
+
+    // Copies the geometry into the heap and returns a handle to it, or std::nullopt if there is no free range large
+    // enough. The sizes of vertices and indices must be multiples of the vertex stride and the index size.
+    [[nodiscard]] std::optional<uint64_t> Allocate(TriviallyCopyableByteSpan vertices, TriviallyCopyableByteSpan indices);
+    void Free(uint64_t allocation);
+
+    // The range stays the same until the heap is defragmented.
+    [[nodiscard]] GeometryRange Range(uint64_t allocation) const;
+    [[nodiscard]] DrawIndexedIndirectCommand DrawCommand(uint64_t allocation,
+                                                         uint32_t instanceCount = 1,
+                                                         uint32_t firstInstance = 0) const;
+
+    // Moves every allocation to the start of the buffers, so that the free space is contiguous.
+    // The buffers are replaced, so they must be bound again, and ranges and draw commands must be queried again.
+    void Defragment();
+
+    [[nodiscard]] const Buffer& VertexBuffer() const
+    {
+      return vertexBuffer_;
+    }
+
+    [[nodiscard]] const Buffer& IndexBuffer() const
+    {
+      return indexBuffer_;
+    }
+
+    [[nodiscard]] uint32_t VertexStride() const
+    {
+      return createInfo_.vertexStride;
+    }
+
+    [[nodiscard]] Fwog::IndexType IndexType() const
+    {
+      return createInfo_.indexType;
+    }
+
+    [[nodiscard]] uint32_t FreeVertexCount() const
+    {
+      return vertexAllocator_.FreeSize();
+    }
+
+    [[nodiscard]] uint32_t FreeIndexCount() const
+    {
+      return indexAllocator_.FreeSize();
+    }
+
+  private:
+    struct Allocation
+    {
+      detail::OffsetAllocator::Allocation vertices;
+      detail::OffsetAllocator::Allocation indices; // unused if indexCount is 0
+      uint32_t vertexCount;
+      uint32_t indexCount;
+    };
+
+    GeometryHeapCreateInfo createInfo_;
+    uint32_t indexSize_;
+    Buffer vertexBuffer_;
+    Buffer indexBuffer_;
+    detail::OffsetAllocator vertexAllocator_;
+    detail::OffsetAllocator indexAllocator_;
+    detail::SlotMap<Allocation> allocations_;
+  };
+
+  // clang-format on
+} // namespace Fwog
@@ -1,8 +1,11 @@
 #pragma once
 #include <Fwog/BasicTypes.h>
 #include <Fwog/detail/Flags.h>
+#include <chrono>
 #include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace Fwog
 {
@@ -13,6 +16,8 @@ namespace Fwog
   {
     PrimitiveTopology topology  = PrimitiveTopology::TRIANGLE_LIST;
     bool primitiveRestartEnable = false;
+
+    bool operator==(const InputAssemblyState&) const noexcept = default;
   };
 
   struct VertexInputBindingDescription
@@ -21,6 +26,8 @@ namespace Fwog
     uint32_t binding;  // glVertexArrayAttribBinding
     Format format;     // glVertexArrayAttribFormat
     uint32_t offset;   // glVertexArrayAttribFormat
+
+    bool operator==(const VertexInputBindingDescription&) const noexcept = default;
   };
 
   struct VertexInputState
@@ -41,6 +48,19 @@ namespace Fwog
     //float depthBiasClamp; // no equivalent core OpenGL function
     float lineWidth               = 1; // glLineWidth
     float pointSize               = 1; // glPointSize
+
+    bool operator==(const RasterizationState&) const noexcept = default;
+  };
+
+  struct MultisampleState
+  {
+    bool sampleShadingEnable   = false;      // gl{Enable, Disable}(GL_SAMPLE_SHADING)
+    float minSampleShading     = 1;          // glMinSampleShading
+    uint32_t sampleMask        = 0xFFFFFFFF; // glSampleMaski
+    bool alphaToCoverageEnable = false;      // gl{Enable, Disable}(GL_SAMPLE_ALPHA_TO_COVERAGE)
+    bool alphaToOneEnable      = false;      // gl{Enable, Disable}(GL_SAMPLE_ALPHA_TO_ONE)
+
+    bool operator==(const MultisampleState&) const noexcept = default;
   };
 
   struct DepthState
@@ -51,6 +71,8 @@ namespace Fwog
     //bool depthBoundsTestEnable; // no equivalent core OpenGL function
     //float minDepthBounds;       // ???
     //float maxDepthBounds;       // ???
+
+    bool operator==(const DepthState&) const noexcept = default;
   };
 
   struct StencilOpState
@@ -71,6 +93,8 @@ namespace Fwog
     bool stencilTestEnable = false;
     StencilOpState front   = {};
     StencilOpState back    = {};
+
+    bool operator==(const StencilState&) const noexcept = default;
   };
 
   struct ColorBlendAttachmentState                                      // glBlendFuncSeparatei + glBlendEquationSeparatei
@@ -103,10 +127,13 @@ namespace Fwog
     InputAssemblyState inputAssemblyState = {};
     VertexInputState vertexInputState     = {};
     RasterizationState rasterizationState = {};
+    MultisampleState multisampleState     = {};
     DepthState depthState                 = {};
     StencilState stencilState             = {};
     ColorBlendState colorBlendState       = {};
-    // Multisample state omitted (stretch goal)
+    // Formats of the color attachments the pipeline renders to. Only used to create the dummy render targets for
+    // pipeline warm-up. Attachments without a format here are warmed up with R8G8B8A8_UNORM.
+    std::span<const Format> warmupColorFormats = {};
     // Tessellation state omitted (stretch goal)
   };
 
@@ -116,6 +143,44 @@ namespace Fwog
     const Shader* shader;
   };
 
+  // A uniform or storage block that a pipeline's program uses
+  struct ReflectedBlock
+  {
+    std::string name;
+    uint32_t binding;
+    uint64_t dataSize;            // minimum size of the bound range; excludes the runtime-sized array of a storage block
+    uint32_t activeVariableCount;
+  };
+
+  // A sampler or image uniform that a pipeline's program uses. Each array element occupies one unit.
+  struct ReflectedOpaqueUniform
+  {
+    std::string name;
+    uint32_t binding; // unit of the first element
+    uint32_t arraySize;
+  };
+
+  // The resources a pipeline's program uses, queried when it is linked.
+  // Resources that the compiler found to be unused are not included.
+  struct PipelineReflection
+  {
+    std::vector<ReflectedBlock> uniformBlocks;
+    std::vector<ReflectedBlock> storageBlocks;
+    std::vector<ReflectedOpaqueUniform> sampledImages;
+    std::vector<ReflectedOpaqueUniform> images;
+
+    // bit i is set if binding i is used, for bindings below 32
+    uint32_t uniformBufferMask = 0;
+    uint32_t storageBufferMask = 0;
+    uint32_t sampledImageMask  = 0;
+    uint32_t imageMask         = 0;
+
+    Extent3D workgroupSize = {}; // compute pipelines only
+  };
+
+  template<typename T>
+  class PendingPipeline;
+
   struct GraphicsPipeline
   {
     GraphicsPipeline(const GraphicsPipelineInfo& info);
@@ -132,7 +197,13 @@ namespace Fwog
       return id_;
     }
 
+    // The reference stays valid until the pipeline is destroyed.
+    [[nodiscard]] const PipelineReflection& Reflection() const;
+
   private:
+    friend class PendingPipeline<GraphicsPipeline>;
+    explicit GraphicsPipeline(uint64_t id) : id_(id) {}
+
     uint64_t id_;
   };
 
@@ -152,9 +223,75 @@ namespace Fwog
       return id_;
     }
 
+    // The reference stays valid until the pipeline is destroyed.
+    [[nodiscard]] const PipelineReflection& Reflection() const;
+
+    // the local_size declared by the compute shader
+    [[nodiscard]] Extent3D WorkgroupSize() const;
+
   private:
+    friend class PendingPipeline<ComputePipeline>;
+    explicit ComputePipeline(uint64_t id) : id_(id) {}
+
     uint64_t id_;
   };
 
+  // A pipeline whose program may still be linking.
+  // If GL_KHR_parallel_shader_compile is supported, the driver links it on its own threads, so many pipelines can be
+  // started up front and waited on later. Otherwise, linking finishes no later than the call to Wait.
+  template<typename T>
+  class PendingPipeline
+  {
+  public:
+    PendingPipeline(PendingPipeline&& old) noexcept;
+    PendingPipeline& operator=(PendingPipeline&& old) noexcept;
+    PendingPipeline(const PendingPipeline&) = delete;
+    PendingPipeline& operator=(const PendingPipeline&) = delete;
+    ~PendingPipeline();
+
+    // Returns true if linking has finished, so Wait will not block on it. Never blocks.
+    // Wait may still take time to warm up the pipeline if warm-up is enabled (see SetPipelineWarmupEnabled).
+    [[nodiscard]] bool IsReady() const;
+
+    // Blocks until the pipeline is linked and returns it. Can only be called once.
+    // Throws PipelineCompilationException if linking failed.
+    [[nodiscard]] T Wait();
+
+  private:
+    friend PendingPipeline<GraphicsPipeline> CompileGraphicsPipelineAsync(const GraphicsPipelineInfo& info);
+    friend PendingPipeline<ComputePipeline> CompileComputePipelineAsync(const ComputePipelineInfo& info);
+    explicit PendingPipeline(uint64_t id) : id_(id) {}
+
+    uint64_t id_{};
+  };
+
+  extern template class PendingPipeline<GraphicsPipeline>;
+  extern template class PendingPipeline<ComputePipeline>;
+
+  // Starts linking a pipeline without waiting for the result.
+  // The shaders referenced by the info can be destroyed as soon as this returns.
+  PendingPipeline<GraphicsPipeline> CompileGraphicsPipelineAsync(const GraphicsPipelineInfo& info);
+  PendingPipeline<ComputePipeline> CompileComputePipelineAsync(const ComputePipelineInfo& info);
+
+  struct PipelineWarmupRecord
+  {
+    std::string name;
+    uint64_t pipeline;                 // the pipeline may have been destroyed since
+    std::chrono::nanoseconds duration; // CPU time spent recording and submitting the empty draw or dispatch
+  };
+
+  // When enabled, every pipeline is bound and used for an empty draw or dispatch right after it is created, so the
+  // driver compiles state-dependent shader variants up front instead of on first use. Graphics pipelines are drawn
+  // into small cached dummy render targets with as many color attachments as the pipeline has blend attachments or
+  // warm-up color formats, and a D32_FLOAT (or D32_FLOAT_S8_UINT if stencil testing is enabled) depth attachment.
+  // Variants that depend on other attachment formats are still compiled on first use.
+  // Pipelines created inside a rendering or compute scope are not warmed up.
+  // Disabling warm-up frees the dummy render targets.
+  void SetPipelineWarmupEnabled(bool enabled);
+
+  // timings of every warm-up since the records were last cleared
+  [[nodiscard]] std::span<const PipelineWarmupRecord> GetPipelineWarmupRecords();
+  void ClearPipelineWarmupRecords();
+
   // clang-format on
 } // namespace Fwog
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  // Source hashes and sizes of the shaders that make up a program, in pipeline stage order. Unused stages are 0.
+  // The sizes are compared along with the hashes, so a hash collision only matters between sources of equal size.
+  struct PipelineCacheKey
+  {
+    uint64_t shaderHashes[2] = {};
+    uint64_t shaderSizes[2] = {};
+
+    bool operator==(const PipelineCacheKey&) const noexcept = default;
+  };
+
+  // A persistent cache of linked program binaries.
+  // Programs are identified by the hashes and sizes of their shader sources. The file also records the driver's vendor,
+  // renderer, and version strings, and is ignored if they do not match the current driver.
+  // The file is memory-mapped when opened, so cached binaries are handed to the driver without being copied.
+  // Programs added during this run are kept in memory until Save is called.
+  // Must be created and destroyed while the context is current.
+  class PipelineCache
+  {
+  public:
+    // Opens the cache file at path. If the file is missing or invalid, the cache starts out empty.
+    explicit PipelineCache(std::string_view path);
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    ~PipelineCache();
+
+    // Writes every cached program to the file. Returns false if the file could not be written.
+    bool Save();
+
+    // Creates a linked program from a cached binary. Returns 0 if the program is not cached, or if the driver rejected
+    // the binary, in which case the entry is dropped.
+    uint32_t LoadProgram(const PipelineCacheKey& key);
+
+    // Retrieves the binary of a successfully linked program and adds it to the cache.
+    void StoreProgram(const PipelineCacheKey& key, uint32_t program);
+
+    [[nodiscard]] size_t Size() const
+    {
+      return entries_.size();
+    }
+
+    [[nodiscard]] uint32_t Hits() const
+    {
+      return hits_;
+    }
+
+    [[nodiscard]] uint32_t Misses() const
+    {
+      return misses_;
+    }
+
+  private:
+    struct KeyHash
+    {
+      size_t operator()(const PipelineCacheKey& key) const noexcept;
+    };
+
+    struct Entry
+    {
+      uint32_t binaryFormat;
+      std::span<const std::byte> binary; // points into the mapped file or into owned
+      std::vector<std::byte> owned;
+    };
+
+    void Load();
+    void Unmap();
+
+    std::string path_;
+    uint64_t driverHash_{};
+    bool supported_{};
+    const std::byte* mappedData_{};
+    size_t mappedSize_{};
+    std::unordered_map<PipelineCacheKey, Entry, KeyHash> entries_;
+    uint32_t hits_{};
+    uint32_t misses_{};
+  };
+
+  // Sets the cache consulted when pipelines are created. Pass nullptr to disable caching.
+  // The cache must stay alive until it is unset.
+  void SetPipelineCache(PipelineCache* cache);
+  [[nodiscard]] PipelineCache* GetPipelineCache();
+
+  // clang-format on
+} // namespace Fwog
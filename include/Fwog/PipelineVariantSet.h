@@ -0,0 +1,101 @@
+#pragma once
+#include <Fwog/Pipeline.h>
+#include <cstdint>
+#include <list>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  class ShaderSourceLoader;
+
+  // A permutation axis. A variant's value for the option is defined in its shaders as #define name value.
+  struct PipelineVariantOption
+  {
+    std::string_view name;
+    uint32_t valueCount = 2; // booleans have the values 0 and 1
+  };
+
+  struct PipelineVariantSetInfo
+  {
+    GraphicsPipelineInfo baseInfo;       // the shaders are ignored and built from the paths below for each variant
+    ShaderSourceLoader* sourceLoader;
+    std::string_view vertexShaderPath;
+    std::string_view fragmentShaderPath; // may be empty
+    std::span<const PipelineVariantOption> options;
+    uint32_t maxResidentVariants = 16;   // least recently used variants beyond this are destroyed
+  };
+
+  // A family of graphics pipelines that share state and shaders, and differ only in the defines selected by a set of
+  // options. A variant is compiled the first time it is requested, so only variants that are used cost compile time
+  // and GL objects. Set a pipeline cache (see SetPipelineCache) to make recompiling evicted variants cheap.
+  class PipelineVariantSet
+  {
+  public:
+    explicit PipelineVariantSet(const PipelineVariantSetInfo& info);
+    PipelineVariantSet(const PipelineVariantSet&) = delete;
+    PipelineVariantSet& operator=(const PipelineVariantSet&) = delete;
+
+    // Returns the variant with the given value for each option, compiling it if it is not resident.
+    // The reference is invalidated by the next call to Get, which may evict the variant.
+    // Throws ShaderCompilationException or PipelineCompilationException if the variant fails to compile.
+    [[nodiscard]] const GraphicsPipeline& Get(std::span<const uint32_t> optionValues);
+
+    // number of variants that can be expressed with the options
+    [[nodiscard]] uint64_t PossibleVariantCount() const
+    {
+      return possibleVariantCount_;
+    }
+
+    // number of distinct variants that have been requested
+    [[nodiscard]] size_t UsedVariantCount() const
+    {
+      return usedVariants_.size();
+    }
+
+    [[nodiscard]] size_t ResidentVariantCount() const
+    {
+      return residentVariants_.size();
+    }
+
+    // number of times a variant was compiled, including recompilations after eviction
+    [[nodiscard]] uint32_t Compiles() const
+    {
+      return compiles_;
+    }
+
+  private:
+    struct ResidentVariant
+    {
+      uint64_t key;
+      GraphicsPipeline pipeline;
+    };
+
+    GraphicsPipeline Compile(uint64_t key, std::span<const uint32_t> optionValues);
+
+    std::string name_;
+    std::vector<VertexInputBindingDescription> vertexBindingDescriptions_;
+    std::vector<ColorBlendAttachmentState> colorBlendAttachments_;
+    std::vector<Format> warmupColorFormats_;
+    GraphicsPipelineInfo baseInfo_;
+    ShaderSourceLoader* sourceLoader_;
+    std::string vertexShaderPath_;
+    std::string fragmentShaderPath_;
+    std::vector<std::string> optionNames_;
+    std::vector<uint32_t> optionValueCounts_;
+    uint32_t maxResidentVariants_;
+    uint64_t possibleVariantCount_ = 1;
+
+    std::list<ResidentVariant> residentVariants_; // most recently used first
+    std::unordered_map<uint64_t, std::list<ResidentVariant>::iterator> residentVariantIndices_;
+    std::unordered_set<uint64_t> usedVariants_;
+    uint32_t compiles_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
@@ -1,6 +1,7 @@
 #pragma once
 #include <Fwog/BasicTypes.h>
 #include <array>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <type_traits>
@@ -12,6 +13,7 @@ namespace Fwog
   class Texture;
   class Sampler;
   class Buffer;
+  class BindGroup;
   struct GraphicsPipeline;
   struct ComputePipeline;
 
@@ -40,8 +42,14 @@ namespace Fwog
   struct RenderAttachment
   {
     const Texture* texture = nullptr;
+    uint32_t level = 0;
+    std::optional<uint32_t> layer; // a single layer (or cubemap face, or 3D slice), or all layers if empty
     ClearValue clearValue;
-    bool clearOnLoad = false;
+    AttachmentLoadOp loadOp = AttachmentLoadOp::LOAD;
+    AttachmentStoreOp storeOp = AttachmentStoreOp::STORE;
+    // If set, the multisampled texture is resolved into this single-sampled texture's first level by EndRendering.
+    // It must have the same format and size as the rendered level. The resolve is done before the store op is applied.
+    const Texture* resolveTexture = nullptr;
   };
 
   // TODO: use these structs
@@ -134,11 +142,17 @@ namespace Fwog
     void BindComputePipeline(const ComputePipeline& pipeline);
 
     // dynamic state
-    // void SetViewports(std::span<const Rect2D> viewports);         // glViewportArrayv
     void SetViewport(const Viewport& viewport); // glViewport
 
+    // Sets the viewports starting at index firstViewport, which vertex shaders select by writing gl_ViewportIndex
+    // (ARB_shader_viewport_layer_array). glViewportArrayv + glDepthRangeArrayv
+    void SetViewports(std::span<const Viewport> viewports, uint32_t firstViewport = 0);
+
     void SetScissor(const Rect2D& scissor); // glScissor
 
+    // sets the scissor rectangles of the viewports starting at index firstScissor. glScissorArrayv
+    void SetScissors(std::span<const Rect2D> scissors, uint32_t firstScissor = 0);
+
     // drawing operations
 
     // glDrawArraysInstancedBaseInstance
@@ -184,7 +198,8 @@ namespace Fwog
 
     // vertex setup
 
-    // glVertexArrayVertexBuffer
+    // Attached to the bound pipeline's vertex array with glVertexArrayVertexBuffers at the next draw.
+    // Vertex arrays are shared by pipelines with the same vertex input state, and keep their buffers between binds.
     void BindVertexBuffer(uint32_t bindingIndex, const Buffer& buffer, uint64_t offset, uint64_t stride);
     
     // glVertexArrayElementBuffer
@@ -194,10 +209,10 @@ namespace Fwog
     // valid in render and compute scopes
     
     // glBindBufferRange
-    void BindUniformBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size);
+    void BindUniformBuffer(uint32_t index, const Buffer& buffer, uint64_t offset = 0, uint64_t size = WHOLE_BUFFER);
 
     // glBindBufferRange
-    void BindStorageBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size);
+    void BindStorageBuffer(uint32_t index, const Buffer& buffer, uint64_t offset = 0, uint64_t size = WHOLE_BUFFER);
 
     // glBindTextureUnit + glBindSampler
     void BindSampledImage(uint32_t index, const Texture& texture, const Sampler& sampler);
@@ -205,6 +220,9 @@ namespace Fwog
     // glBindImageTexture{s}
     void BindImage(uint32_t index, const Texture& texture, uint32_t level);
 
+    // binds every resource in the group (see BindGroup)
+    void BindGroup(const Fwog::BindGroup& group);
+
     void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ);
     void DispatchIndirect(const Buffer& commandBuffer, uint64_t commandBufferOffset);
     void MemoryBarrier(MemoryBarrierAccessBits accessBits);
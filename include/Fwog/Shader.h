@@ -1,6 +1,10 @@
 #pragma once
 #include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
 #include <string_view>
+#include <variant>
 
 namespace Fwog
 {
@@ -11,22 +15,54 @@ namespace Fwog
     COMPUTE_SHADER
   };
 
+  // Overrides the default value of a SPIR-V specialization constant (OpSpecConstant with SpecId index)
+  struct SpecializationConstant
+  {
+    uint32_t index;
+    std::variant<uint32_t, int32_t, float, bool> value;
+  };
+
   class Shader
   {
   public:
     explicit Shader(PipelineStage stage, std::string_view source);
+
+    // Creates a shader from a SPIR-V module with glShaderBinary and glSpecializeShader (GL_ARB_gl_spirv).
+    explicit Shader(PipelineStage stage,
+                    std::span<const uint32_t> spirv,
+                    std::string_view entryPoint = "main",
+                    std::span<const SpecializationConstant> specializationConstants = {});
     Shader(const Shader&) = delete;
     Shader(Shader&& old) noexcept;
     Shader& operator=(const Shader&) = delete;
     Shader& operator=(Shader&& old) noexcept;
     ~Shader();
 
-    [[nodiscard]] uint32_t Handle() const
+    // While a pipeline cache is set (see SetPipelineCache), compilation is deferred until the handle is first
+    // requested, which only happens when a pipeline using the shader misses the cache.
+    // Throws ShaderCompilationException if deferred compilation fails.
+    [[nodiscard]] uint32_t Handle() const;
+
+    // stable hash of the stage and source (or SPIR-V module, entry point, and specialization constants), used to
+    // identify programs in the pipeline cache
+    [[nodiscard]] uint64_t SourceHash() const
     {
-      return id_;
+      return sourceHash_;
     }
 
+    // size in bytes of the data SourceHash hashes, which the pipeline cache also compares to reject hash collisions
+    [[nodiscard]] uint64_t SourceSize() const
+    {
+      return sourceSize_;
+    }
+
+    // the hash SourceHash returns for a shader created from stage and source
+    [[nodiscard]] static uint64_t HashSource(PipelineStage stage, std::string_view source);
+
   private:
-    uint32_t id_{};
+    mutable uint32_t id_{};
+    uint64_t sourceHash_{};
+    uint64_t sourceSize_{};
+    mutable std::function<uint32_t()> deferredCompile_;
   };
 } // namespace Fwog
\ No newline at end of file
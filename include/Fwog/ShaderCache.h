@@ -0,0 +1,70 @@
+#pragma once
+#include <Fwog/Shader.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Fwog
+{
+  // clang-format off
+  // Deduplicates shader objects. Shaders are identified by their stage and source, so requesting a shader that was
+  // already compiled returns the existing object instead of compiling it again. Lookups are keyed by the source hash
+  // (see Shader::SourceHash), and the full source is compared on a hit.
+  // Shaders stay alive while they are referenced by the cache or by a caller.
+  // Must be destroyed while the context is current.
+  class ShaderCache
+  {
+  public:
+    ShaderCache() = default;
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    // Returns the cached shader for the stage and source, compiling it on a miss.
+    // Throws ShaderCompilationException if compilation fails, in which case nothing is cached.
+    [[nodiscard]] std::shared_ptr<const Shader> GetOrCompile(PipelineStage stage, std::string_view source);
+
+    // Drops every shader that is only referenced by the cache. Returns the number of shaders that were dropped.
+    size_t Trim();
+
+    void Clear();
+
+    [[nodiscard]] size_t Size() const
+    {
+      return shaders_.size();
+    }
+
+    [[nodiscard]] uint32_t Hits() const
+    {
+      return hits_;
+    }
+
+    [[nodiscard]] uint32_t Misses() const
+    {
+      return misses_;
+    }
+
+    // fraction of lookups that did not compile a shader, or 0 if there were no lookups
+    [[nodiscard]] float HitRate() const
+    {
+      const uint32_t lookups = hits_ + misses_;
+      return lookups == 0 ? 0.0f : static_cast<float>(hits_) / static_cast<float>(lookups);
+    }
+
+  private:
+    struct Entry
+    {
+      PipelineStage stage;
+      std::string source;
+      std::shared_ptr<const Shader> shader;
+    };
+
+    std::unordered_multimap<uint64_t, Entry> shaders_;
+    uint32_t hits_{};
+    uint32_t misses_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  // A macro that is defined at the top of a loaded shader, as if by #define name value
+  struct ShaderDefine
+  {
+    std::string_view name;
+    std::string_view value = "";
+  };
+
+  struct ShaderSource
+  {
+    std::string source;
+    uint64_t hash; // hash of the expanded source
+  };
+
+  // Loads GLSL files and expands their #include "path" directives.
+  // Included paths are resolved relative to the including file first, then relative to each include directory in
+  // order. Every file is read and parsed once, and its expanded contents are kept, so shaders that share headers do
+  // not re-read or re-expand them.
+  // Included text is surrounded by #line directives whose source string number is the file's index in the loader
+  // (see GetSourceStringPath), so compiler errors can be traced back to the file they came from.
+  class ShaderSourceLoader
+  {
+  public:
+    explicit ShaderSourceLoader(std::vector<std::string> includeDirectories = {});
+
+    // Returns the expanded source of the file at path, with defines inserted after the #version directive.
+    // Throws ShaderCompilationException if a file cannot be read or includes itself.
+    [[nodiscard]] ShaderSource Load(std::string_view path, std::span<const ShaderDefine> defines = {});
+
+    // Paths of every file the file at path includes, directly or indirectly, in the order they are first included.
+    // Throws ShaderCompilationException if a file cannot be read.
+    [[nodiscard]] std::vector<std::string> GetDependencies(std::string_view path);
+
+    // Discards the cached contents of a file that has changed on disk, and the expansions of every file that includes it.
+    void Invalidate(std::string_view path);
+
+    // Path of the file with the given #line source string number, or an empty string if there is no such file
+    [[nodiscard]] std::string_view GetSourceStringPath(uint32_t sourceStringNumber) const;
+
+    // number of times a file was read from disk
+    [[nodiscard]] uint32_t FileReads() const
+    {
+      return fileReads_;
+    }
+
+  private:
+    struct Include
+    {
+      size_t begin;      // offset of the directive
+      size_t end;        // offset of the end of the directive's line
+      uint32_t nextLine; // number of the line after the directive
+      uint32_t file;
+    };
+
+    struct File
+    {
+      std::string path;
+      bool loaded = false;
+      std::string text;
+      std::vector<Include> includes;
+      std::vector<uint32_t> includedBy;
+      std::optional<std::string> expanded;
+    };
+
+    uint32_t GetFileIndex(std::string_view path);
+    File& GetLoadedFile(uint32_t index);
+    const std::string& Expand(uint32_t index, std::vector<uint32_t>& includeStack);
+
+    std::vector<std::string> includeDirectories_;
+    std::deque<File> files_; // index is the source string number
+    std::unordered_map<std::string, uint32_t> fileIndices_;
+    uint32_t fileReads_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
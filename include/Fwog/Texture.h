@@ -2,6 +2,7 @@
 #include <Fwog/BasicTypes.h>
 #include <cstdint>
 #include <string_view>
+#include <vector>
 
 namespace Fwog
 {
@@ -95,6 +96,9 @@ namespace Fwog
     // create a view of a single mip or layer of this texture
     [[nodiscard]] TextureView CreateMipView(uint32_t level) const;
     [[nodiscard]] TextureView CreateLayerView(uint32_t layer) const;
+
+    // Returns a resident bindless handle for sampling the texture with the sampler. The handle stays resident until the
+    // texture is destroyed. Use a BindlessResidencyManager instead to bound the memory kept resident.
     [[nodiscard]] uint64_t GetBindlessHandle(Sampler sampler);
 
     [[nodiscard]] const TextureCreateInfo& CreateInfo() const
@@ -114,7 +118,7 @@ namespace Fwog
     Texture();
     uint32_t id_{};
     TextureCreateInfo createInfo_{};
-    uint64_t bindlessHandle_ = 0;
+    std::vector<uint64_t> bindlessHandles_; // resident handles, one per sampler
   };
 
   // TODO: implement
@@ -0,0 +1,93 @@
+#pragma once
+#include <Fwog/Buffer.h>
+#include <Fwog/Fence.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace Fwog
+{
+  // clang-format off
+  // Memory for count values of type T that the GPU reads in the current frame.
+  // buffer, offset, and size can be passed directly to Cmd::BindUniformBuffer or Cmd::BindStorageBuffer.
+  template<typename T>
+  struct UploadAllocation
+  {
+    T* data;              // write-only, and visible to the GPU without flushing
+    const Buffer* buffer;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  // A persistently mapped buffer that transient per-frame data, such as per-draw uniforms, is written to directly.
+  // The buffer is split into one region per frame in flight. Each frame allocates linearly from its region, and a fence
+  // signaled at the end of the frame guards the region until the GPU has finished reading it. Allocations are aligned
+  // for both uniform and storage buffer binding.
+  class UploadRing
+  {
+  public:
+    // frameSize is the number of bytes that can be allocated each frame
+    explicit UploadRing(uint64_t frameSize, uint32_t framesInFlight = 3);
+    ~UploadRing();
+    UploadRing(const UploadRing&) = delete;
+    UploadRing& operator=(const UploadRing&) = delete;
+
+    // Makes the next region current, waiting for the GPU to finish reading it if needed.
+    // Must be called before allocating in a frame.
+    void BeginFrame();
+
+    // Must be called after the last command that reads the frame's allocations.
+    void EndFrame();
+
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] UploadAllocation<T> Allocate(uint64_t count = 1)
+    {
+      uint64_t offset{};
+      auto* data = static_cast<T*>(AllocateBytes(sizeof(T) * count, alignof(T), offset));
+      return {data, &buffer_, offset, sizeof(T) * count};
+    }
+
+    // allocates and copies a single value
+    template<typename T>
+    requires std::is_trivially_copyable_v<T>
+    [[nodiscard]] UploadAllocation<T> Upload(const T& value)
+    {
+      auto allocation = Allocate<T>();
+      std::memcpy(allocation.data, &value, sizeof(T));
+      return allocation;
+    }
+
+    [[nodiscard]] const Buffer& GetBuffer() const
+    {
+      return buffer_;
+    }
+
+    // bytes allocated in the current frame, including alignment padding
+    [[nodiscard]] uint64_t FrameUsage() const
+    {
+      return head_ - frame_ * frameSize_;
+    }
+
+  private:
+    void* AllocateBytes(uint64_t size, uint64_t alignment, uint64_t& offset);
+
+    struct Region
+    {
+      Fence fence;
+      bool pending{}; // the fence was signaled and has not been waited on
+    };
+
+    uint64_t alignment_;
+    uint64_t frameSize_; // a multiple of the alignment, so every region starts aligned
+    Buffer buffer_;
+    std::byte* mapping_;
+    std::vector<Region> regions_;
+    uint32_t frame_{};
+    uint64_t head_{};
+    bool inFrame_{};
+  };
+
+  // clang-format on
+} // namespace Fwog
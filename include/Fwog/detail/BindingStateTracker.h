@@ -0,0 +1,94 @@
+#pragma once
+#include <Fwog/BindGroup.h>
+#include <Fwog/Pipeline.h>
+#include <glad/gl.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+
+namespace Fwog::detail
+{
+  constexpr uint32_t MAX_TRACKED_UNIFORM_BUFFERS = 32;
+  constexpr uint32_t MAX_TRACKED_STORAGE_BUFFERS = 32;
+  constexpr uint32_t MAX_TRACKED_TEXTURE_UNITS = 32;
+  constexpr uint32_t MAX_TRACKED_IMAGE_UNITS = 16;
+
+  template<uint32_t N>
+  struct BufferBindingTable
+  {
+    // structure of arrays so ranges can be passed directly to glBindBuffersRange
+    std::array<GLuint, N> buffers{};
+    std::array<GLintptr, N> offsets{};
+    std::array<GLsizeiptr, N> sizes{};
+    uint32_t dirty{};
+    uint32_t wholeBuffer{}; // bit i is set if slot i was bound with WHOLE_BUFFER
+  };
+
+  struct TextureBindingTable
+  {
+    std::array<GLuint, MAX_TRACKED_TEXTURE_UNITS> textures{};
+    std::array<GLuint, MAX_TRACKED_TEXTURE_UNITS> samplers{};
+    uint32_t dirty{};
+  };
+
+  struct ImageBindingTable
+  {
+    std::array<GLuint, MAX_TRACKED_IMAGE_UNITS> textures{};
+    std::array<GLint, MAX_TRACKED_IMAGE_UNITS> levels{};
+    std::array<GLenum, MAX_TRACKED_IMAGE_UNITS> formats{};
+    uint32_t dirty{};
+  };
+
+  // Shadows the indexed resource bindings of the context.
+  // Binds that match the shadowed state are dropped. Other binds are only recorded, and are submitted at the next
+  // draw or dispatch with one multi-bind call per resource class.
+  // Bindings that do not fit in the tables are forwarded to the driver immediately.
+  // Slots the bound program does not use are not flushed, and stay pending until a program that uses them is bound.
+  class BindingStateTracker
+  {
+  public:
+    // If wholeBuffer is true, size is the rest of the buffer, and the range is clamped to the size of the block the
+    // program declares at index when it is flushed.
+    void BindUniformBuffer(uint32_t index, GLuint buffer, GLintptr offset, GLsizeiptr size, bool wholeBuffer = false);
+    void BindStorageBuffer(uint32_t index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void BindSampledImage(uint32_t index, GLuint texture, GLuint sampler);
+    void BindImage(uint32_t index, GLuint texture, GLint level, GLenum format);
+
+    // records every binding of the group, unless it was the last group bound and nothing was bound since
+    void BindGroup(const Fwog::BindGroup& group);
+
+    // limits flushing to the slots used by the program about to be bound
+    void SetUsedSlots(const PipelineReflection& reflection);
+
+    // submits the pending bindings of used slots
+    void Flush();
+
+    // Must be called when a buffer or texture is deleted. The context unbinds deleted objects, and their names may be
+    // reused for new objects that would otherwise be mistaken for the old binding.
+    void RemoveBuffer(GLuint buffer);
+    void RemoveTexture(GLuint texture);
+
+  private:
+    // true if every binding of the group is already recorded in the tables
+    bool IsBound(const Fwog::BindGroup& group) const;
+
+    // emits a debug message when the bound program uses slots that have nothing bound
+    void ReportEmptySlots();
+
+    BufferBindingTable<MAX_TRACKED_UNIFORM_BUFFERS> uniformBuffers_;
+    BufferBindingTable<MAX_TRACKED_STORAGE_BUFFERS> storageBuffers_;
+    TextureBindingTable sampledImages_;
+    ImageBindingTable images_;
+
+    uint32_t usedUniformBuffers_ = ~0u;
+    uint32_t usedStorageBuffers_ = ~0u;
+    uint32_t usedSampledImages_ = ~0u;
+    uint32_t usedImages_ = ~0u;
+    std::array<GLsizeiptr, MAX_TRACKED_UNIFORM_BUFFERS> usedUniformBlockSizes_{}; // 0 where no block is declared
+    std::array<uint32_t, 4> lastReportedEmptySlots_{};
+
+    // hash of the last bind group, reset by any other bind. Only used to reject groups quickly, since different
+    // groups can have the same hash.
+    std::optional<uint64_t> boundGroupHash_;
+  };
+} // namespace Fwog::detail
@@ -1,45 +1,71 @@
 #pragma once
 #include "Fwog/Rendering.h"
 #include "Fwog/Texture.h"
+#include "Fwog/detail/PipelineManager.h"
 
+#include <array>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
-#include <optional>
 
 namespace Fwog::detail
 {
-  struct TextureProxy
+  constexpr uint32_t ALL_LAYERS = static_cast<uint32_t>(-1);
+
+  struct FramebufferAttachmentKey
   {
-    TextureCreateInfo createInfo;
-    uint32_t id;
+    uint32_t texture{}; // 0 if the attachment is unused
+    uint32_t level{};
+    uint32_t layer{};   // ALL_LAYERS attaches every layer
 
-    bool operator==(const TextureProxy&) const noexcept = default;
+    bool operator==(const FramebufferAttachmentKey&) const noexcept = default;
   };
 
-  struct RenderAttachments
+  // Identifies a framebuffer by the texture names, levels and layers of its attachments.
+  // Names are unique while their textures are alive, and framebuffers are evicted when one of their textures is
+  // destroyed, so a reused name cannot match a stale framebuffer.
+  struct FramebufferKey
   {
-    std::vector<TextureProxy> colorAttachments{};
-    std::optional<TextureProxy> depthAttachment{};
-    std::optional<TextureProxy> stencilAttachment{};
+    std::array<FramebufferAttachmentKey, MAX_COLOR_ATTACHMENTS> colorAttachments{};
+    uint32_t colorAttachmentCount{};
+    FramebufferAttachmentKey depthAttachment{};
+    FramebufferAttachmentKey stencilAttachment{};
+    uint64_t hash{};
 
-    bool operator==(const RenderAttachments& rhs) const;
+    bool operator==(const FramebufferKey&) const noexcept = default;
   };
 
+  // Caches a framebuffer for each combination of attachments.
+  // Lookups use an open-addressing table and do not allocate. A reverse index from each texture to the framebuffers
+  // that use it makes removing a texture proportional to the number of framebuffers it is attached to.
   class FramebufferCache
   {
   public:
     uint32_t CreateOrGetCachedFramebuffer(const RenderInfo& renderInfo);
     std::size_t Size() const
     {
-      return framebufferCacheKey_.size();
+      return size_;
     }
     void Clear();
 
+    // Must be called when a texture is deleted, otherwise the cache becomes invalid.
     void RemoveTexture(const Texture& texture);
 
   private:
-    std::vector<RenderAttachments> framebufferCacheKey_;
-    std::vector<uint32_t> framebufferCacheValue_;
+    struct Slot
+    {
+      FramebufferKey key;
+      uint32_t fbo{}; // 0 if the slot is empty
+    };
+
+    // returns the slot that holds the key, or the empty slot where it would be inserted
+    Slot& FindSlot(const FramebufferKey& key);
+    void Insert(const FramebufferKey& key, uint32_t fbo);
+    void Erase(const FramebufferKey& key);
+    void Grow();
+
+    std::vector<Slot> slots_; // power of two size, linear probing
+    std::size_t size_{};
+    std::unordered_map<uint32_t, std::vector<FramebufferKey>> textureFramebuffers_;
   };
 } // namespace Fwog::detail
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <tuple>
 
@@ -7,6 +9,17 @@ namespace Fwog::detail::hashing
   template<typename T>
   struct hash;
 
+  // 64-bit FNV-1a. Unlike std::hash, the result is the same across runs and platforms, so it can be persisted.
+  inline uint64_t fnv1a(const void* data, size_t size, uint64_t seed = 14695981039346656037ull)
+  {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+      seed = (seed ^ bytes[i]) * 1099511628211ull;
+    }
+    return seed;
+  }
+
   template<class T>
   inline void hash_combine(std::size_t& seed, const T& v)
   {
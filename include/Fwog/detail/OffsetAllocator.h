@@ -0,0 +1,81 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace Fwog::detail
+{
+  // Sub-allocates ranges of a fixed-size resource, in arbitrary units, with a two-level segregated fit (TLSF) scheme.
+  // Free ranges are kept in bins whose sizes follow a floating-point distribution with a 3-bit mantissa, and two levels
+  // of bitmasks find a bin that can hold a request in constant time. Freed ranges are merged with free neighbours.
+  // Only the bookkeeping is done here, the resource itself is managed by the caller.
+  class OffsetAllocator
+  {
+  public:
+    static constexpr uint32_t INVALID_NODE = static_cast<uint32_t>(-1);
+
+    struct Allocation
+    {
+      uint32_t offset;
+      uint32_t node; // identifies the allocation when it is freed
+    };
+
+    explicit OffsetAllocator(uint32_t size);
+
+    // returns std::nullopt if no free range is large enough
+    [[nodiscard]] std::optional<Allocation> Allocate(uint32_t size);
+    void Free(uint32_t node);
+
+    // frees every allocation
+    void Reset();
+
+    // Frees every allocation, then allocates ranges of the given sizes back to back from offset 0, in order.
+    // Unlike repeated calls to Allocate, this cannot fail because of bin rounding, so the sizes only have to fit in
+    // total.
+    [[nodiscard]] std::vector<Allocation> ResetPacked(std::span<const uint32_t> sizes);
+
+    [[nodiscard]] uint32_t Size() const
+    {
+      return size_;
+    }
+
+    // total size of the free ranges, which may be fragmented
+    [[nodiscard]] uint32_t FreeSize() const
+    {
+      return freeSize_;
+    }
+
+    [[nodiscard]] uint32_t LargestFreeRange() const;
+
+  private:
+    static constexpr uint32_t BINS_PER_GROUP = 8;
+    static constexpr uint32_t GROUP_COUNT = 32;
+
+    struct Node
+    {
+      uint32_t offset{};
+      uint32_t size{};
+      uint32_t binPrev = INVALID_NODE;      // free ranges in the same bin
+      uint32_t binNext = INVALID_NODE;
+      uint32_t neighborPrev = INVALID_NODE; // adjacent ranges in the resource
+      uint32_t neighborNext = INVALID_NODE;
+      bool used{};
+    };
+
+    // takes size units from the start of a free node, leaving the rest free
+    Allocation UseFreeNode(uint32_t node, uint32_t size);
+    uint32_t CreateNode(uint32_t offset, uint32_t size);
+    void InsertFreeNode(uint32_t node);
+    void RemoveFreeNode(uint32_t node);
+
+    uint32_t size_;
+    uint32_t freeSize_{};
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> unusedNodes_;
+    std::array<uint32_t, BINS_PER_GROUP * GROUP_COUNT> binHeads_{};
+    std::array<uint8_t, GROUP_COUNT> binMasks_{}; // bit i is set if bin i of the group is not empty
+    uint32_t groupMask_{};                        // bit i is set if group i has a non-empty bin
+  };
+} // namespace Fwog::detail
@@ -1,11 +1,42 @@
 #pragma once
 #include <Fwog/Pipeline.h>
+#include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 namespace Fwog::detail
 {
+  constexpr uint32_t MAX_COLOR_ATTACHMENTS = 8;
+
+  class VertexArrayState;
+
+  // groups of pipeline state that are applied together when any of their members changes
+  enum class PipelineStateGroup : uint32_t
+  {
+    INPUT_ASSEMBLY,
+    VERTEX_INPUT,
+    RASTERIZATION, // includes multisample state
+    DEPTH_BIAS,
+    DEPTH,
+    STENCIL,
+    COLOR_BLEND,
+    COUNT,
+  };
+
+  // Packed ids of a graphics pipeline's state groups.
+  // Each group is interned when the pipeline is created, so two pipelines have the same id for a group exactly when
+  // that group's state is identical. Ids are never reused, so they can be compared even after a pipeline is destroyed.
+  // An id of 0 means no state (e.g. an unused color attachment).
+  struct alignas(64) GraphicsPipelineStateBlock
+  {
+    uint32_t serial{}; // unique for every pipeline
+    std::array<uint32_t, static_cast<size_t>(PipelineStateGroup::COUNT)> groups{};
+    std::array<uint32_t, MAX_COLOR_ATTACHMENTS> colorBlendAttachments{};
+  };
+  static_assert(sizeof(GraphicsPipelineStateBlock) == 64);
+
   // owning versions of pipeline info structs so we don't lose references
   struct VertexInputStateOwning
   {
@@ -22,25 +53,49 @@ namespace Fwog::detail
 
   struct GraphicsPipelineInfoOwning
   {
+    GraphicsPipelineStateBlock stateBlock;
+    uint32_t program;
+    VertexArrayState* vertexArray; // owned by the vertex array cache
     std::string name;
+    std::unique_ptr<PipelineReflection> reflection; // stable when the pipeline storage grows
     InputAssemblyState inputAssemblyState;
     VertexInputStateOwning vertexInputState;
     RasterizationState rasterizationState;
+    MultisampleState multisampleState;
     DepthState depthState;
     StencilState stencilState;
     ColorBlendStateOwning colorBlendState;
+    std::vector<Format> warmupColorFormats;
   };
 
   struct ComputePipelineInfoOwning
   {
+    uint32_t program;
     std::string name;
+    std::unique_ptr<PipelineReflection> reflection;
   };
 
-  uint64_t CompileGraphicsPipelineInternal(const GraphicsPipelineInfo& info);
-  std::shared_ptr<const GraphicsPipelineInfoOwning> GetGraphicsPipelineInternal(uint64_t pipeline);
+  // Pipelines are referred to by slot map handles rather than by their program, see SlotMap.
+  // The returned pointers are invalidated when another pipeline of the same kind is created.
+  // If async is true, the link status is not checked, and must be checked with CheckProgramLinkStatusInternal before
+  // the pipeline is used. The pipeline's reflection is then empty until Reflect*PipelineInternal is called.
+  uint64_t CompileGraphicsPipelineInternal(const GraphicsPipelineInfo& info, bool async = false);
+  const GraphicsPipelineInfoOwning* GetGraphicsPipelineInternal(uint64_t pipeline);
   void DestroyGraphicsPipelineInternal(uint64_t pipeline);
+  void ReflectGraphicsPipelineInternal(uint64_t pipeline);
 
-  uint64_t CompileComputePipelineInternal(const ComputePipelineInfo& info);
-  std::shared_ptr<const ComputePipelineInfoOwning> GetComputePipelineInternal(uint64_t pipeline);
+  uint64_t CompileComputePipelineInternal(const ComputePipelineInfo& info, bool async = false);
+  const ComputePipelineInfoOwning* GetComputePipelineInternal(uint64_t pipeline);
   void DestroyComputePipelineInternal(uint64_t pipeline);
+  void ReflectComputePipelineInternal(uint64_t pipeline);
+
+  // must be called when a buffer is deleted, see VertexArrayState::RemoveBuffer
+  void RemoveBufferFromVertexArraysInternal(uint32_t buffer);
+
+  // requests as many compiler threads as the driver allows, if GL_KHR_parallel_shader_compile is supported
+  void EnableParallelCompilationInternal();
+  // returns true if checking the link status will not block
+  bool IsProgramLinkCompleteInternal(uint32_t program);
+  // blocks until the program is linked and throws PipelineCompilationException if linking failed
+  void CheckProgramLinkStatusInternal(uint32_t program);
 } // namespace Fwog::detail
\ No newline at end of file
@@ -0,0 +1,9 @@
+#pragma once
+#include <Fwog/Pipeline.h>
+#include <cstdint>
+
+namespace Fwog::detail
+{
+  // queries the resources used by a linked program
+  PipelineReflection ReflectProgram(uint32_t program, bool isCompute);
+} // namespace Fwog::detail
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Fwog::detail
+{
+  // Stores values contiguously and refers to them with 64-bit handles: the slot's generation in the upper 32 bits and
+  // its index in the lower 32 bits.
+  // A slot's generation is incremented when its value is erased, so handles to erased values never resolve to a newer
+  // value in the same slot. Generations start at 1, so a valid handle is never 0.
+  // Pointers returned by Get are invalidated by Insert.
+  template<typename T>
+  class SlotMap
+  {
+  public:
+    uint64_t Insert(T value)
+    {
+      uint32_t index;
+      if (!freeList_.empty())
+      {
+        index = freeList_.back();
+        freeList_.pop_back();
+      }
+      else
+      {
+        index = static_cast<uint32_t>(slots_.size());
+        slots_.emplace_back();
+      }
+
+      auto& slot = slots_[index];
+      slot.value.emplace(std::move(value));
+      return (static_cast<uint64_t>(slot.generation) << 32) | index;
+    }
+
+    [[nodiscard]] T* Get(uint64_t handle)
+    {
+      const auto index = static_cast<uint32_t>(handle);
+      const auto generation = static_cast<uint32_t>(handle >> 32);
+      if (index >= slots_.size() || slots_[index].generation != generation || !slots_[index].value)
+      {
+        return nullptr;
+      }
+      return &*slots_[index].value;
+    }
+
+    [[nodiscard]] const T* Get(uint64_t handle) const
+    {
+      return const_cast<SlotMap*>(this)->Get(handle);
+    }
+
+    // returns the erased value
+    std::optional<T> Erase(uint64_t handle)
+    {
+      if (!Get(handle))
+      {
+        return std::nullopt;
+      }
+
+      const auto index = static_cast<uint32_t>(handle);
+      auto& slot = slots_[index];
+      std::optional<T> value = std::exchange(slot.value, std::nullopt);
+
+      // skip 0 when the generation wraps around
+      if (++slot.generation == 0)
+      {
+        slot.generation = 1;
+      }
+      freeList_.push_back(index);
+      return value;
+    }
+
+    [[nodiscard]] size_t Size() const
+    {
+      return slots_.size() - freeList_.size();
+    }
+
+    // calls f with every stored value
+    template<typename F>
+    void ForEach(F&& f)
+    {
+      for (auto& slot : slots_)
+      {
+        if (slot.value)
+        {
+          f(*slot.value);
+        }
+      }
+    }
+
+  private:
+    struct Slot
+    {
+      std::optional<T> value;
+      uint32_t generation = 1;
+    };
+
+    std::vector<Slot> slots_;
+    std::vector<uint32_t> freeList_;
+  };
+} // namespace Fwog::detail
@@ -1,23 +1,82 @@
 #pragma once
+#include <Fwog/Pipeline.h>
+#include <glad/gl.h>
+#include <array>
 #include <cstddef>
 #include <cstdint>
-#include <unordered_map>
+#include <memory>
+#include <span>
+#include <vector>
 
 namespace Fwog::detail
 {
-  struct VertexInputStateOwning;
+  // the minimum value of GL_MAX_VERTEX_ATTRIB_BINDINGS
+  constexpr uint32_t MAX_TRACKED_VERTEX_BUFFERS = 16;
 
+  // A cached vertex array and a shadow of the buffers attached to it.
+  // Binds that match the attached buffers are dropped. Vertex buffer binds are only recorded, and are attached at the
+  // next draw with one glVertexArrayVertexBuffers call.
+  class VertexArrayState
+  {
+  public:
+    explicit VertexArrayState(GLuint vao) : vao_(vao) {}
+
+    [[nodiscard]] GLuint Handle() const
+    {
+      return vao_;
+    }
+
+    void BindVertexBuffer(uint32_t bindingIndex, GLuint buffer, GLintptr offset, GLsizei stride);
+    void BindIndexBuffer(GLuint buffer);
+
+    // attaches the pending vertex buffers
+    void Flush();
+
+    // Must be called when a buffer is deleted, as its name may be reused for a new buffer that would otherwise be
+    // mistaken for the old attachment.
+    void RemoveBuffer(GLuint buffer);
+
+  private:
+    GLuint vao_;
+
+    // structure of arrays so ranges can be passed directly to glVertexArrayVertexBuffers
+    std::array<GLuint, MAX_TRACKED_VERTEX_BUFFERS> buffers_{};
+    std::array<GLintptr, MAX_TRACKED_VERTEX_BUFFERS> offsets_{};
+    std::array<GLsizei, MAX_TRACKED_VERTEX_BUFFERS> strides_{};
+    uint32_t dirty_{};
+    GLuint indexBuffer_{};
+  };
+
+  // Caches a vertex array for each distinct vertex input state.
+  // Lookups use an open-addressing table keyed by the full binding descriptions, so states whose hashes collide never
+  // share a vertex array. Pipelines look up their vertex array once when they are created.
   class VertexArrayCache
   {
   public:
-    uint32_t CreateOrGetCachedVertexArray(const VertexInputStateOwning& inputState);
+    // the returned pointer stays valid until the cache is cleared
+    VertexArrayState* CreateOrGetCachedVertexArray(std::span<const VertexInputBindingDescription> bindingDescriptions);
     size_t Size() const
     {
-      return vertexArrayCache_.size();
+      return size_;
     }
     void Clear();
 
+    // forgets the buffer in every vertex array's shadow state
+    void RemoveBuffer(GLuint buffer);
+
   private:
-    std::unordered_map<size_t, uint32_t> vertexArrayCache_;
+    struct Slot
+    {
+      std::vector<VertexInputBindingDescription> bindingDescriptions;
+      uint64_t hash{};
+      std::unique_ptr<VertexArrayState> state; // null if the slot is empty
+    };
+
+    // returns the slot that holds the state, or the empty slot where it would be inserted
+    Slot& FindSlot(std::span<const VertexInputBindingDescription> bindingDescriptions, uint64_t hash);
+    void Grow();
+
+    std::vector<Slot> slots_; // power of two size, linear probing
+    size_t size_{};
   };
 } // namespace Fwog::detail
@@ -0,0 +1,90 @@
+#include <Fwog/BindGroup.h>
+#include <Fwog/Buffer.h>
+#include <Fwog/Common.h>
+#include <Fwog/detail/ApiToEnum.h>
+#include <Fwog/detail/BindingStateTracker.h>
+#include <Fwog/detail/Hash.h>
+#include <algorithm>
+
+namespace Fwog
+{
+  namespace
+  {
+    // returns the entries sorted by slot
+    template<typename T>
+    std::vector<T> SortedBySlot(std::span<const T> entries, [[maybe_unused]] uint32_t maxSlots)
+    {
+      std::vector<T> sorted(entries.begin(), entries.end());
+      std::sort(sorted.begin(), sorted.end(), [](const T& a, const T& b) { return a.index < b.index; });
+      for ([[maybe_unused]] size_t i = 0; i < sorted.size(); i++)
+      {
+        FWOG_ASSERT(sorted[i].index < maxSlots && "Bind groups can only use slots that the binding state tracks");
+        FWOG_ASSERT((i == 0 || sorted[i - 1].index != sorted[i].index) && "A slot can only be bound once in a group");
+      }
+      return sorted;
+    }
+
+    template<typename T>
+    uint64_t HashVector(const std::vector<T>& values, uint64_t hash)
+    {
+      return detail::hashing::fnv1a(values.data(), values.size() * sizeof(T), hash);
+    }
+  } // namespace
+
+  BindGroup::BindGroup(const BindGroupInfo& info)
+  {
+    auto resolveBuffers = [](std::span<const BindGroupBuffer> entries, uint32_t maxSlots, Buffers& buffers)
+    {
+      for (const auto& entry : SortedBySlot(entries, maxSlots))
+      {
+        FWOG_ASSERT(entry.offset <= entry.buffer->Size());
+        buffers.mask |= 1u << entry.index;
+        buffers.wholeBuffer |= entry.size == WHOLE_BUFFER ? 1u << entry.index : 0;
+        buffers.names.push_back(entry.buffer->Handle());
+        buffers.offsets.push_back(static_cast<int64_t>(entry.offset));
+        buffers.sizes.push_back(
+          static_cast<int64_t>(entry.size == WHOLE_BUFFER ? entry.buffer->Size() - entry.offset : entry.size));
+      }
+    };
+
+    resolveBuffers(info.uniformBuffers, detail::MAX_TRACKED_UNIFORM_BUFFERS, uniformBuffers_);
+    resolveBuffers(info.storageBuffers, detail::MAX_TRACKED_STORAGE_BUFFERS, storageBuffers_);
+
+    for (const auto& entry : SortedBySlot(info.sampledImages, detail::MAX_TRACKED_TEXTURE_UNITS))
+    {
+      sampledImages_.mask |= 1u << entry.index;
+      sampledImages_.textures.push_back(entry.texture->Handle());
+      sampledImages_.samplers.push_back(entry.sampler.Handle());
+    }
+
+    for (const auto& entry : SortedBySlot(info.images, detail::MAX_TRACKED_IMAGE_UNITS))
+    {
+      FWOG_ASSERT(entry.level < entry.texture->CreateInfo().mipLevels);
+      images_.mask |= 1u << entry.index;
+      images_.textures.push_back(entry.texture->Handle());
+      images_.levels.push_back(static_cast<int32_t>(entry.level));
+      images_.formats.push_back(static_cast<uint32_t>(detail::FormatToGL(entry.texture->CreateInfo().format)));
+    }
+
+    const uint32_t masks[] = {
+      uniformBuffers_.mask,
+      uniformBuffers_.wholeBuffer,
+      storageBuffers_.mask,
+      storageBuffers_.wholeBuffer,
+      sampledImages_.mask,
+      images_.mask,
+    };
+    hash_ = detail::hashing::fnv1a(masks, sizeof(masks));
+    for (const auto* buffers : {&uniformBuffers_, &storageBuffers_})
+    {
+      hash_ = HashVector(buffers->names, hash_);
+      hash_ = HashVector(buffers->offsets, hash_);
+      hash_ = HashVector(buffers->sizes, hash_);
+    }
+    hash_ = HashVector(sampledImages_.textures, hash_);
+    hash_ = HashVector(sampledImages_.samplers, hash_);
+    hash_ = HashVector(images_.textures, hash_);
+    hash_ = HashVector(images_.levels, hash_);
+    hash_ = HashVector(images_.formats, hash_);
+  }
+} // namespace Fwog
@@ -0,0 +1,265 @@
+#include <Fwog/BindlessResidencyManager.h>
+#include <Fwog/Common.h>
+#include <algorithm>
+#include <span>
+
+namespace Fwog
+{
+  namespace
+  {
+    // managers are not movable, so their addresses are stable
+    std::vector<BindlessResidencyManager*> sResidencyManagers;
+
+    uint32_t FormatToBytesPerTexel(Format format)
+    {
+      switch (format)
+      {
+      case Format::R8_UNORM:
+      case Format::R8_SNORM:
+      case Format::R3G3B2_UNORM:
+      case Format::R8_SINT:
+      case Format::R8_UINT: return 1;
+      case Format::R16_UNORM:
+      case Format::R16_SNORM:
+      case Format::R8G8_UNORM:
+      case Format::R8G8_SNORM:
+      case Format::R4G4B4_UNORM:
+      case Format::R5G5B5_UNORM:
+      case Format::R2G2B2A2_UNORM:
+      case Format::R4G4B4A4_UNORM:
+      case Format::R5G5B5A1_UNORM:
+      case Format::R16_FLOAT:
+      case Format::R16_SINT:
+      case Format::R16_UINT:
+      case Format::R8G8_SINT:
+      case Format::R8G8_UINT:
+      case Format::D16_UNORM: return 2;
+      case Format::R8G8B8_UNORM:
+      case Format::R8G8B8_SNORM:
+      case Format::R8G8B8_SRGB:
+      case Format::R8G8B8_SINT:
+      case Format::R8G8B8_UINT:
+      case Format::D24_UNORM: return 3;
+      case Format::R16G16_UNORM:
+      case Format::R16G16_SNORM:
+      case Format::R10G10B10_UNORM:
+      case Format::R8G8B8A8_UNORM:
+      case Format::R8G8B8A8_SNORM:
+      case Format::R10G10B10A2_UNORM:
+      case Format::R10G10B10A2_UINT:
+      case Format::R8G8B8A8_SRGB:
+      case Format::R16G16_FLOAT:
+      case Format::R32_FLOAT:
+      case Format::R11G11B10_FLOAT:
+      case Format::R9G9B9_E5:
+      case Format::R32_SINT:
+      case Format::R32_UINT:
+      case Format::R16G16_SINT:
+      case Format::R16G16_UINT:
+      case Format::R8G8B8A8_SINT:
+      case Format::R8G8B8A8_UINT:
+      case Format::D32_FLOAT:
+      case Format::D32_UNORM:
+      case Format::D24_UNORM_S8_UINT: return 4;
+      case Format::R12G12B12_UNORM: return 5;
+      case Format::R16G16B16_SNORM:
+      case Format::R12G12B12A12_UNORM:
+      case Format::R16G16B16_FLOAT:
+      case Format::R16G16B16_SINT:
+      case Format::R16G16B16_UINT: return 6;
+      case Format::R16G16B16A16_UNORM:
+      case Format::R16G16B16A16_FLOAT:
+      case Format::R32G32_FLOAT:
+      case Format::R32G32_SINT:
+      case Format::R32G32_UINT:
+      case Format::R16G16B16A16_SINT:
+      case Format::R16G16B16A16_UINT:
+      case Format::D32_FLOAT_S8_UINT: return 8;
+      case Format::R32G32B32_FLOAT:
+      case Format::R32G32B32_SINT:
+      case Format::R32G32B32_UINT: return 12;
+      case Format::R32G32B32A32_FLOAT:
+      case Format::R32G32B32A32_SINT:
+      case Format::R32G32B32A32_UINT: return 16;
+      default: FWOG_UNREACHABLE; return 0;
+      }
+    }
+
+    // size of the texture's storage, ignoring the driver's padding
+    uint64_t EstimateTextureBytes(const TextureCreateInfo& info)
+    {
+      uint64_t texels = 0;
+      for (uint32_t level = 0; level < std::max(info.mipLevels, 1u); level++)
+      {
+        texels += uint64_t(std::max(info.extent.width >> level, 1u)) * std::max(info.extent.height >> level, 1u) *
+                  std::max(info.extent.depth >> level, 1u);
+      }
+
+      const uint64_t faces = info.imageType == ImageType::TEX_CUBEMAP ? 6 : 1;
+      const uint64_t samples = uint64_t(1) << static_cast<uint32_t>(info.sampleCount);
+      return texels * std::max(info.arrayLayers, 1u) * faces * samples * FormatToBytesPerTexel(info.format);
+    }
+  } // namespace
+
+  namespace detail
+  {
+    void RemoveTextureFromResidencyManagers(uint32_t texture)
+    {
+      if (texture == 0)
+      {
+        return;
+      }
+
+      for (auto* manager : sResidencyManagers)
+      {
+        manager->RemoveTexture(texture);
+      }
+    }
+  } // namespace detail
+
+  BindlessResidencyManager::BindlessResidencyManager(uint32_t capacity, uint64_t residentBudgetBytes)
+      : entries_(capacity),
+        handles_(capacity),
+        dirtyBegin_(capacity),
+        handleTable_(sizeof(uint64_t) * capacity, BufferStorageFlag::DYNAMIC_STORAGE),
+        residentBudgetBytes_(residentBudgetBytes)
+  {
+    FWOG_ASSERT(capacity > 0);
+
+    // hand out low indices first
+    freeIndices_.reserve(capacity);
+    for (uint32_t i = capacity; i > 0; i--)
+    {
+      freeIndices_.push_back(i - 1);
+    }
+
+    sResidencyManagers.push_back(this);
+  }
+
+  BindlessResidencyManager::~BindlessResidencyManager()
+  {
+    std::erase(sResidencyManagers, this);
+
+    for (auto& entry : entries_)
+    {
+      if (entry.resident)
+      {
+        MakeNonResident(entry);
+      }
+    }
+  }
+
+  uint32_t BindlessResidencyManager::Reference(const Texture& texture, const Sampler& sampler)
+  {
+    const uint64_t key = uint64_t(texture.Handle()) << 32 | sampler.Handle();
+    auto it = indices_.find(key);
+    if (it == indices_.end())
+    {
+      FWOG_ASSERT(!freeIndices_.empty() && "The handle table is full");
+      const uint32_t index = freeIndices_.back();
+      freeIndices_.pop_back();
+
+      const uint64_t handle = glGetTextureSamplerHandleARB(texture.Handle(), sampler.Handle());
+      FWOG_ASSERT(handle != 0 && "Failed to create texture sampler handle.");
+      entries_[index] = {
+        .key = key,
+        .handle = handle,
+        .bytes = EstimateTextureBytes(texture.CreateInfo()),
+        .lastReferenced = updateCount_,
+        .resident = false,
+      };
+      SetTableEntry(index, handle);
+      it = indices_.emplace(key, index).first;
+    }
+
+    auto& entry = entries_[it->second];
+    entry.lastReferenced = updateCount_;
+    if (!entry.resident)
+    {
+      MakeResident(entry);
+    }
+    return it->second;
+  }
+
+  void BindlessResidencyManager::Update()
+  {
+    if (residentBytes_ > residentBudgetBytes_)
+    {
+      // handles referenced since the last update may be sampled this frame, so they are never evicted
+      std::vector<Entry*> candidates;
+      for (auto& entry : entries_)
+      {
+        if (entry.resident && entry.lastReferenced < updateCount_)
+        {
+          candidates.push_back(&entry);
+        }
+      }
+
+      std::sort(candidates.begin(),
+                candidates.end(),
+                [](const Entry* a, const Entry* b) { return a->lastReferenced < b->lastReferenced; });
+
+      for (size_t i = 0; i < candidates.size() && residentBytes_ > residentBudgetBytes_; i++)
+      {
+        MakeNonResident(*candidates[i]);
+        evictions_++;
+      }
+    }
+
+    if (dirtyBegin_ < dirtyEnd_)
+    {
+      handleTable_.SubData(std::span(handles_).subspan(dirtyBegin_, dirtyEnd_ - dirtyBegin_),
+                           sizeof(uint64_t) * dirtyBegin_);
+      dirtyBegin_ = static_cast<uint32_t>(handles_.size());
+      dirtyEnd_ = 0;
+    }
+
+    updateCount_++;
+  }
+
+  void BindlessResidencyManager::MakeResident(Entry& entry)
+  {
+    glMakeTextureHandleResidentARB(entry.handle);
+    entry.resident = true;
+    residentBytes_ += entry.bytes;
+    residentHandleCount_++;
+  }
+
+  void BindlessResidencyManager::MakeNonResident(Entry& entry)
+  {
+    glMakeTextureHandleNonResidentARB(entry.handle);
+    entry.resident = false;
+    residentBytes_ -= entry.bytes;
+    residentHandleCount_--;
+  }
+
+  void BindlessResidencyManager::SetTableEntry(uint32_t index, uint64_t handle)
+  {
+    handles_[index] = handle;
+    dirtyBegin_ = std::min(dirtyBegin_, index);
+    dirtyEnd_ = std::max(dirtyEnd_, index + 1);
+  }
+
+  // called before the texture is deleted, so its handles can still be made non-resident
+  void BindlessResidencyManager::RemoveTexture(uint32_t texture)
+  {
+    for (uint32_t index = 0; index < entries_.size(); index++)
+    {
+      auto& entry = entries_[index];
+      if (entry.key == 0 || entry.key >> 32 != texture)
+      {
+        continue;
+      }
+
+      if (entry.resident)
+      {
+        MakeNonResident(entry);
+      }
+
+      indices_.erase(entry.key);
+      entry = {};
+      SetTableEntry(index, 0);
+      freeIndices_.push_back(index);
+    }
+  }
+} // namespace Fwog
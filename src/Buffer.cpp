@@ -1,13 +1,20 @@
 #include <Fwog/Buffer.h>
 #include <Fwog/Common.h>
 #include <Fwog/detail/ApiToEnum.h>
+#include <Fwog/detail/BindingStateTracker.h>
+#include <Fwog/detail/PipelineManager.h>
 #include <utility>
 
 namespace Fwog
 {
+  extern detail::BindingStateTracker sBindingTracker;
+
   Buffer::Buffer(const void* data, size_t size, BufferStorageFlags storageFlags, BufferMapFlags mapFlags)
       : size_(std::max(size, static_cast<size_t>(1)))
   {
+    FWOG_ASSERT(!(mapFlags & (BufferMapFlag::MAP_INVALIDATE_RANGE | BufferMapFlag::MAP_INVALIDATE_BUFFER |
+                              BufferMapFlag::MAP_FLUSH_EXPLICIT | BufferMapFlag::MAP_UNSYNCHRONIZED)) &&
+                "These flags only apply to mapping");
     GLbitfield glflags = detail::BufferStorageFlagsToGL(storageFlags);
     glflags |= detail::BufferMapFlagsToGL(mapFlags);
     glCreateBuffers(1, &id_);
@@ -26,7 +33,8 @@ namespace Fwog
 
   Buffer::Buffer(Buffer&& old) noexcept
       : size_(std::exchange(old.size_, 0)), id_(std::exchange(old.id_, 0)),
-        isMapped_(std::exchange(old.isMapped_, false))
+        isMapped_(std::exchange(old.isMapped_, false)), mappedSize_(std::exchange(old.mappedSize_, 0)),
+        mappedFlags_(std::exchange(old.mappedFlags_, BufferMapFlag::NONE))
   {
   }
 
@@ -44,6 +52,8 @@ namespace Fwog
     if (id_)
     {
       glDeleteBuffers(1, &id_);
+      sBindingTracker.RemoveBuffer(id_);
+      detail::RemoveBufferFromVertexArraysInternal(id_);
     }
   }
 
@@ -59,16 +69,37 @@ namespace Fwog
   }
 
   void* Buffer::Map(BufferMapFlags flags) const
+  {
+    return MapRange(0, Size(), flags);
+  }
+
+  void* Buffer::MapRange(size_t offset, size_t size, BufferMapFlags flags) const
   {
     FWOG_ASSERT(!IsMapped() && "Buffers cannot be mapped more than once at a time");
+    FWOG_ASSERT(size > 0 && offset + size <= Size());
     isMapped_ = true;
-    return glMapNamedBufferRange(id_, 0, Size(), detail::BufferMapFlagsToGL(flags));
+    mappedSize_ = size;
+    mappedFlags_ = flags;
+    return glMapNamedBufferRange(id_,
+                                 static_cast<GLintptr>(offset),
+                                 static_cast<GLsizeiptr>(size),
+                                 detail::BufferMapFlagsToGL(flags));
+  }
+
+  void Buffer::FlushMappedRange(size_t offset, size_t size) const
+  {
+    FWOG_ASSERT(IsMapped() && "Only mapped buffers can be flushed");
+    FWOG_ASSERT(mappedFlags_ & BufferMapFlag::MAP_FLUSH_EXPLICIT && "The range must be mapped with MAP_FLUSH_EXPLICIT");
+    FWOG_ASSERT(offset + size <= mappedSize_);
+    glFlushMappedNamedBufferRange(id_, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
   }
 
   void Buffer::Unmap() const
   {
     FWOG_ASSERT(IsMapped() && "Buffers that aren't mapped cannot be unmapped");
     isMapped_ = false;
+    mappedSize_ = 0;
+    mappedFlags_ = BufferMapFlag::NONE;
     glUnmapNamedBuffer(id_);
   }
 
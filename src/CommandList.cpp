@@ -0,0 +1,651 @@
+#include <Fwog/Buffer.h>
+#include <Fwog/CommandList.h>
+#include <Fwog/Common.h>
+#include <Fwog/Pipeline.h>
+#include <Fwog/Texture.h>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+namespace Fwog
+{
+  namespace detail
+  {
+    enum class CommandType : uint32_t
+    {
+      BEGIN_SWAPCHAIN_RENDERING,
+      BEGIN_RENDERING,
+      END_RENDERING,
+      BEGIN_COMPUTE,
+      END_COMPUTE,
+      BIND_GRAPHICS_PIPELINE,
+      BIND_COMPUTE_PIPELINE,
+      SET_VIEWPORT,
+      SET_VIEWPORTS,
+      SET_SCISSOR,
+      SET_SCISSORS,
+      DRAW,
+      DRAW_INDEXED,
+      DRAW_INDIRECT,
+      DRAW_INDIRECT_COUNT,
+      DRAW_INDEXED_INDIRECT,
+      DRAW_INDEXED_INDIRECT_COUNT,
+      BIND_VERTEX_BUFFER,
+      BIND_INDEX_BUFFER,
+      BIND_UNIFORM_BUFFER,
+      BIND_STORAGE_BUFFER,
+      BIND_SAMPLED_IMAGE,
+      BIND_IMAGE,
+      BIND_GROUP,
+      DISPATCH,
+      DISPATCH_INDIRECT,
+      MEMORY_BARRIER,
+    };
+  } // namespace detail
+
+  namespace
+  {
+    // every command starts with this header, and every header is aligned to kCommandAlignment
+    struct CommandHeader
+    {
+      detail::CommandType type;
+      uint32_t size; // size of the whole command (header + payload + padding) in bytes
+    };
+
+    constexpr size_t kCommandAlignment = 8;
+    constexpr size_t kHeaderSize = (sizeof(CommandHeader) + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+
+    constexpr size_t AlignUp(size_t value)
+    {
+      return (value + kCommandAlignment - 1) & ~(kCommandAlignment - 1);
+    }
+
+    // variable-length payloads are followed by their trailing data (attachments, then the name)
+    struct CmdBeginSwapchainRendering
+    {
+      SwapchainRenderInfo info; // name is stored after the payload
+      uint32_t nameLength;
+    };
+
+    struct CmdBeginRendering
+    {
+      Viewport viewport;
+      RenderAttachment depthAttachment;
+      RenderAttachment stencilAttachment;
+      bool hasViewport;
+      bool hasDepthAttachment;
+      bool hasStencilAttachment;
+      uint32_t colorAttachmentCount;
+      uint32_t nameLength;
+    };
+
+    struct CmdBeginCompute
+    {
+      uint32_t nameLength;
+    };
+
+    struct CmdBindGraphicsPipeline
+    {
+      const GraphicsPipeline* pipeline;
+    };
+
+    struct CmdBindComputePipeline
+    {
+      const ComputePipeline* pipeline;
+    };
+
+    struct CmdSetViewport
+    {
+      Viewport viewport;
+    };
+
+    // followed by the viewports
+    struct CmdSetViewports
+    {
+      uint32_t firstViewport;
+      uint32_t viewportCount;
+    };
+
+    struct CmdSetScissor
+    {
+      Rect2D scissor;
+    };
+
+    // followed by the scissors
+    struct CmdSetScissors
+    {
+      uint32_t firstScissor;
+      uint32_t scissorCount;
+    };
+
+    struct CmdDraw
+    {
+      uint32_t vertexCount;
+      uint32_t instanceCount;
+      uint32_t firstVertex;
+      uint32_t firstInstance;
+    };
+
+    struct CmdDrawIndexed
+    {
+      uint32_t indexCount;
+      uint32_t instanceCount;
+      uint32_t firstIndex;
+      int32_t vertexOffset;
+      uint32_t firstInstance;
+    };
+
+    struct CmdDrawIndirect
+    {
+      const Buffer* commandBuffer;
+      uint64_t commandBufferOffset;
+      uint32_t drawCount;
+      uint32_t stride;
+    };
+
+    struct CmdDrawIndirectCount
+    {
+      const Buffer* commandBuffer;
+      uint64_t commandBufferOffset;
+      const Buffer* countBuffer;
+      uint64_t countBufferOffset;
+      uint32_t maxDrawCount;
+      uint32_t stride;
+    };
+
+    struct CmdBindVertexBuffer
+    {
+      const Buffer* buffer;
+      uint64_t offset;
+      uint64_t stride;
+      uint32_t bindingIndex;
+    };
+
+    struct CmdBindIndexBuffer
+    {
+      const Buffer* buffer;
+      IndexType indexType;
+    };
+
+    struct CmdBindBufferRange
+    {
+      const Buffer* buffer;
+      uint64_t offset;
+      uint64_t size;
+      uint32_t index;
+    };
+
+    struct CmdBindSampledImage
+    {
+      const Texture* texture;
+      Sampler sampler; // samplers are cheap handles that are commonly created on the fly, so they are copied
+      uint32_t index;
+    };
+
+    struct CmdBindImage
+    {
+      const Texture* texture;
+      uint32_t index;
+      uint32_t level;
+    };
+
+    struct CmdBindGroup
+    {
+      const Fwog::BindGroup* group;
+    };
+
+    struct CmdDispatch
+    {
+      uint32_t groupCountX;
+      uint32_t groupCountY;
+      uint32_t groupCountZ;
+    };
+
+    struct CmdDispatchIndirect
+    {
+      const Buffer* commandBuffer;
+      uint64_t commandBufferOffset;
+    };
+
+    struct CmdMemoryBarrier
+    {
+      MemoryBarrierAccessBits accessBits;
+    };
+
+    template<typename T>
+    const T& PayloadAs(const std::byte* payload)
+    {
+      return *std::launder(reinterpret_cast<const T*>(payload));
+    }
+
+    void CopyName(std::byte* trailing, std::string_view name)
+    {
+      if (!name.empty())
+      {
+        std::memcpy(trailing, name.data(), name.size());
+      }
+    }
+
+    std::string_view TrailingName(const std::byte* trailing, uint32_t length)
+    {
+      return {reinterpret_cast<const char*>(trailing), length};
+    }
+  } // namespace
+
+  std::byte* CommandList::Allocate(detail::CommandType type, size_t payloadSize)
+  {
+    const size_t commandSize = kHeaderSize + AlignUp(payloadSize);
+    const size_t offset = data_.size();
+    data_.resize(offset + commandSize);
+
+    new (data_.data() + offset) CommandHeader{type, static_cast<uint32_t>(commandSize)};
+    commandCount_++;
+    return data_.data() + offset + kHeaderSize;
+  }
+
+  template<typename T>
+  void CommandList::Push(detail::CommandType type, const T& command)
+  {
+    static_assert(std::is_trivially_destructible_v<T>);
+    static_assert(alignof(T) <= kCommandAlignment);
+    new (Allocate(type, sizeof(T))) T(command);
+  }
+
+  void CommandList::BeginSwapchainRendering(const SwapchainRenderInfo& renderInfo)
+  {
+    const auto nameLength = static_cast<uint32_t>(renderInfo.name.size());
+    std::byte* payload = Allocate(detail::CommandType::BEGIN_SWAPCHAIN_RENDERING,
+                                  AlignUp(sizeof(CmdBeginSwapchainRendering)) + nameLength);
+    auto* cmd = new (payload) CmdBeginSwapchainRendering{renderInfo, nameLength};
+    cmd->info.name = {};
+    CopyName(payload + AlignUp(sizeof(CmdBeginSwapchainRendering)), renderInfo.name);
+  }
+
+  void CommandList::BeginRendering(const RenderInfo& renderInfo)
+  {
+    const auto colorCount = static_cast<uint32_t>(renderInfo.colorAttachments.size());
+    const auto nameLength = static_cast<uint32_t>(renderInfo.name.size());
+    const size_t attachmentsOffset = AlignUp(sizeof(CmdBeginRendering));
+    const size_t nameOffset = attachmentsOffset + AlignUp(sizeof(RenderAttachment) * colorCount);
+
+    std::byte* payload = Allocate(detail::CommandType::BEGIN_RENDERING, nameOffset + nameLength);
+    auto* cmd = new (payload) CmdBeginRendering{
+      .hasViewport = renderInfo.viewport != nullptr,
+      .hasDepthAttachment = renderInfo.depthAttachment != nullptr,
+      .hasStencilAttachment = renderInfo.stencilAttachment != nullptr,
+      .colorAttachmentCount = colorCount,
+      .nameLength = nameLength,
+    };
+    if (renderInfo.viewport)
+    {
+      cmd->viewport = *renderInfo.viewport;
+    }
+    if (renderInfo.depthAttachment)
+    {
+      cmd->depthAttachment = *renderInfo.depthAttachment;
+    }
+    if (renderInfo.stencilAttachment)
+    {
+      cmd->stencilAttachment = *renderInfo.stencilAttachment;
+    }
+
+    auto* colorAttachments = reinterpret_cast<RenderAttachment*>(payload + attachmentsOffset);
+    for (uint32_t i = 0; i < colorCount; i++)
+    {
+      new (colorAttachments + i) RenderAttachment(renderInfo.colorAttachments[i]);
+    }
+
+    CopyName(payload + nameOffset, renderInfo.name);
+  }
+
+  void CommandList::EndRendering()
+  {
+    Allocate(detail::CommandType::END_RENDERING, 0);
+  }
+
+  void CommandList::BeginCompute(std::string_view name)
+  {
+    const auto nameLength = static_cast<uint32_t>(name.size());
+    std::byte* payload =
+      Allocate(detail::CommandType::BEGIN_COMPUTE, AlignUp(sizeof(CmdBeginCompute)) + nameLength);
+    new (payload) CmdBeginCompute{nameLength};
+    CopyName(payload + AlignUp(sizeof(CmdBeginCompute)), name);
+  }
+
+  void CommandList::EndCompute()
+  {
+    Allocate(detail::CommandType::END_COMPUTE, 0);
+  }
+
+  void CommandList::BindGraphicsPipeline(const GraphicsPipeline& pipeline)
+  {
+    Push(detail::CommandType::BIND_GRAPHICS_PIPELINE, CmdBindGraphicsPipeline{&pipeline});
+  }
+
+  void CommandList::BindComputePipeline(const ComputePipeline& pipeline)
+  {
+    Push(detail::CommandType::BIND_COMPUTE_PIPELINE, CmdBindComputePipeline{&pipeline});
+  }
+
+  void CommandList::SetViewport(const Viewport& viewport)
+  {
+    Push(detail::CommandType::SET_VIEWPORT, CmdSetViewport{viewport});
+  }
+
+  void CommandList::SetViewports(std::span<const Viewport> viewports, uint32_t firstViewport)
+  {
+    const auto viewportCount = static_cast<uint32_t>(viewports.size());
+    std::byte* payload = Allocate(detail::CommandType::SET_VIEWPORTS,
+                                  AlignUp(sizeof(CmdSetViewports)) + sizeof(Viewport) * viewportCount);
+    new (payload) CmdSetViewports{firstViewport, viewportCount};
+    std::memcpy(payload + AlignUp(sizeof(CmdSetViewports)), viewports.data(), sizeof(Viewport) * viewportCount);
+  }
+
+  void CommandList::SetScissor(const Rect2D& scissor)
+  {
+    Push(detail::CommandType::SET_SCISSOR, CmdSetScissor{scissor});
+  }
+
+  void CommandList::SetScissors(std::span<const Rect2D> scissors, uint32_t firstScissor)
+  {
+    const auto scissorCount = static_cast<uint32_t>(scissors.size());
+    std::byte* payload = Allocate(detail::CommandType::SET_SCISSORS,
+                                  AlignUp(sizeof(CmdSetScissors)) + sizeof(Rect2D) * scissorCount);
+    new (payload) CmdSetScissors{firstScissor, scissorCount};
+    std::memcpy(payload + AlignUp(sizeof(CmdSetScissors)), scissors.data(), sizeof(Rect2D) * scissorCount);
+  }
+
+  void CommandList::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
+  {
+    Push(detail::CommandType::DRAW, CmdDraw{vertexCount, instanceCount, firstVertex, firstInstance});
+  }
+
+  void CommandList::DrawIndexed(
+    uint32_t indexCount, uint32_t instanceCount, uint32_t firstIndex, int32_t vertexOffset, uint32_t firstInstance)
+  {
+    Push(detail::CommandType::DRAW_INDEXED,
+         CmdDrawIndexed{indexCount, instanceCount, firstIndex, vertexOffset, firstInstance});
+  }
+
+  void CommandList::DrawIndirect(const Buffer& commandBuffer,
+                                 uint64_t commandBufferOffset,
+                                 uint32_t drawCount,
+                                 uint32_t stride)
+  {
+    Push(detail::CommandType::DRAW_INDIRECT, CmdDrawIndirect{&commandBuffer, commandBufferOffset, drawCount, stride});
+  }
+
+  void CommandList::DrawIndirectCount(const Buffer& commandBuffer,
+                                      uint64_t commandBufferOffset,
+                                      const Buffer& countBuffer,
+                                      uint64_t countBufferOffset,
+                                      uint32_t maxDrawCount,
+                                      uint32_t stride)
+  {
+    Push(detail::CommandType::DRAW_INDIRECT_COUNT,
+         CmdDrawIndirectCount{
+           &commandBuffer, commandBufferOffset, &countBuffer, countBufferOffset, maxDrawCount, stride});
+  }
+
+  void CommandList::DrawIndexedIndirect(const Buffer& commandBuffer,
+                                        uint64_t commandBufferOffset,
+                                        uint32_t drawCount,
+                                        uint32_t stride)
+  {
+    Push(detail::CommandType::DRAW_INDEXED_INDIRECT,
+         CmdDrawIndirect{&commandBuffer, commandBufferOffset, drawCount, stride});
+  }
+
+  void CommandList::DrawIndexedIndirectCount(const Buffer& commandBuffer,
+                                             uint64_t commandBufferOffset,
+                                             const Buffer& countBuffer,
+                                             uint64_t countBufferOffset,
+                                             uint32_t maxDrawCount,
+                                             uint32_t stride)
+  {
+    Push(detail::CommandType::DRAW_INDEXED_INDIRECT_COUNT,
+         CmdDrawIndirectCount{
+           &commandBuffer, commandBufferOffset, &countBuffer, countBufferOffset, maxDrawCount, stride});
+  }
+
+  void CommandList::BindVertexBuffer(uint32_t bindingIndex, const Buffer& buffer, uint64_t offset, uint64_t stride)
+  {
+    Push(detail::CommandType::BIND_VERTEX_BUFFER, CmdBindVertexBuffer{&buffer, offset, stride, bindingIndex});
+  }
+
+  void CommandList::BindIndexBuffer(const Buffer& buffer, IndexType indexType)
+  {
+    Push(detail::CommandType::BIND_INDEX_BUFFER, CmdBindIndexBuffer{&buffer, indexType});
+  }
+
+  void CommandList::BindUniformBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size)
+  {
+    Push(detail::CommandType::BIND_UNIFORM_BUFFER, CmdBindBufferRange{&buffer, offset, size, index});
+  }
+
+  void CommandList::BindStorageBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size)
+  {
+    Push(detail::CommandType::BIND_STORAGE_BUFFER, CmdBindBufferRange{&buffer, offset, size, index});
+  }
+
+  void CommandList::BindSampledImage(uint32_t index, const Texture& texture, const Sampler& sampler)
+  {
+    Push(detail::CommandType::BIND_SAMPLED_IMAGE, CmdBindSampledImage{&texture, sampler, index});
+  }
+
+  void CommandList::BindImage(uint32_t index, const Texture& texture, uint32_t level)
+  {
+    Push(detail::CommandType::BIND_IMAGE, CmdBindImage{&texture, index, level});
+  }
+
+  void CommandList::BindGroup(const Fwog::BindGroup& group)
+  {
+    Push(detail::CommandType::BIND_GROUP, CmdBindGroup{&group});
+  }
+
+  void CommandList::Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
+  {
+    Push(detail::CommandType::DISPATCH, CmdDispatch{groupCountX, groupCountY, groupCountZ});
+  }
+
+  void CommandList::DispatchIndirect(const Buffer& commandBuffer, uint64_t commandBufferOffset)
+  {
+    Push(detail::CommandType::DISPATCH_INDIRECT, CmdDispatchIndirect{&commandBuffer, commandBufferOffset});
+  }
+
+  void CommandList::MemoryBarrier(MemoryBarrierAccessBits accessBits)
+  {
+    Push(detail::CommandType::MEMORY_BARRIER, CmdMemoryBarrier{accessBits});
+  }
+
+  void CommandList::Reset()
+  {
+    data_.clear();
+    commandCount_ = 0;
+  }
+
+  void CommandList::Execute() const
+  {
+    const std::byte* cursor = data_.data();
+    const std::byte* end = data_.data() + data_.size();
+
+    while (cursor < end)
+    {
+      const auto& header = PayloadAs<CommandHeader>(cursor);
+      const std::byte* payload = cursor + kHeaderSize;
+      FWOG_ASSERT(header.size >= kHeaderSize && cursor + header.size <= end);
+
+      switch (header.type)
+      {
+      case detail::CommandType::BEGIN_SWAPCHAIN_RENDERING:
+      {
+        const auto& cmd = PayloadAs<CmdBeginSwapchainRendering>(payload);
+        SwapchainRenderInfo info = cmd.info;
+        info.name = TrailingName(payload + AlignUp(sizeof(CmdBeginSwapchainRendering)), cmd.nameLength);
+        Fwog::BeginSwapchainRendering(info);
+        break;
+      }
+      case detail::CommandType::BEGIN_RENDERING:
+      {
+        const auto& cmd = PayloadAs<CmdBeginRendering>(payload);
+        const size_t attachmentsOffset = AlignUp(sizeof(CmdBeginRendering));
+        const size_t nameOffset = attachmentsOffset + AlignUp(sizeof(RenderAttachment) * cmd.colorAttachmentCount);
+        const auto* colorAttachments = reinterpret_cast<const RenderAttachment*>(payload + attachmentsOffset);
+        Fwog::BeginRendering({
+          .name = TrailingName(payload + nameOffset, cmd.nameLength),
+          .viewport = cmd.hasViewport ? &cmd.viewport : nullptr,
+          .colorAttachments = {colorAttachments, cmd.colorAttachmentCount},
+          .depthAttachment = cmd.hasDepthAttachment ? &cmd.depthAttachment : nullptr,
+          .stencilAttachment = cmd.hasStencilAttachment ? &cmd.stencilAttachment : nullptr,
+        });
+        break;
+      }
+      case detail::CommandType::END_RENDERING: Fwog::EndRendering(); break;
+      case detail::CommandType::BEGIN_COMPUTE:
+      {
+        const auto& cmd = PayloadAs<CmdBeginCompute>(payload);
+        Fwog::BeginCompute(TrailingName(payload + AlignUp(sizeof(CmdBeginCompute)), cmd.nameLength));
+        break;
+      }
+      case detail::CommandType::END_COMPUTE: Fwog::EndCompute(); break;
+      case detail::CommandType::BIND_GRAPHICS_PIPELINE:
+        Cmd::BindGraphicsPipeline(*PayloadAs<CmdBindGraphicsPipeline>(payload).pipeline);
+        break;
+      case detail::CommandType::BIND_COMPUTE_PIPELINE:
+        Cmd::BindComputePipeline(*PayloadAs<CmdBindComputePipeline>(payload).pipeline);
+        break;
+      case detail::CommandType::SET_VIEWPORT: Cmd::SetViewport(PayloadAs<CmdSetViewport>(payload).viewport); break;
+      case detail::CommandType::SET_VIEWPORTS:
+      {
+        const auto& cmd = PayloadAs<CmdSetViewports>(payload);
+        const auto* viewports = reinterpret_cast<const Viewport*>(payload + AlignUp(sizeof(CmdSetViewports)));
+        Cmd::SetViewports({viewports, cmd.viewportCount}, cmd.firstViewport);
+        break;
+      }
+      case detail::CommandType::SET_SCISSOR: Cmd::SetScissor(PayloadAs<CmdSetScissor>(payload).scissor); break;
+      case detail::CommandType::SET_SCISSORS:
+      {
+        const auto& cmd = PayloadAs<CmdSetScissors>(payload);
+        const auto* scissors = reinterpret_cast<const Rect2D*>(payload + AlignUp(sizeof(CmdSetScissors)));
+        Cmd::SetScissors({scissors, cmd.scissorCount}, cmd.firstScissor);
+        break;
+      }
+      case detail::CommandType::DRAW:
+      {
+        const auto& cmd = PayloadAs<CmdDraw>(payload);
+        Cmd::Draw(cmd.vertexCount, cmd.instanceCount, cmd.firstVertex, cmd.firstInstance);
+        break;
+      }
+      case detail::CommandType::DRAW_INDEXED:
+      {
+        const auto& cmd = PayloadAs<CmdDrawIndexed>(payload);
+        Cmd::DrawIndexed(cmd.indexCount, cmd.instanceCount, cmd.firstIndex, cmd.vertexOffset, cmd.firstInstance);
+        break;
+      }
+      case detail::CommandType::DRAW_INDIRECT:
+      {
+        const auto& cmd = PayloadAs<CmdDrawIndirect>(payload);
+        Cmd::DrawIndirect(*cmd.commandBuffer, cmd.commandBufferOffset, cmd.drawCount, cmd.stride);
+        break;
+      }
+      case detail::CommandType::DRAW_INDIRECT_COUNT:
+      {
+        const auto& cmd = PayloadAs<CmdDrawIndirectCount>(payload);
+        Cmd::DrawIndirectCount(*cmd.commandBuffer,
+                               cmd.commandBufferOffset,
+                               *cmd.countBuffer,
+                               cmd.countBufferOffset,
+                               cmd.maxDrawCount,
+                               cmd.stride);
+        break;
+      }
+      case detail::CommandType::DRAW_INDEXED_INDIRECT:
+      {
+        const auto& cmd = PayloadAs<CmdDrawIndirect>(payload);
+        Cmd::DrawIndexedIndirect(*cmd.commandBuffer, cmd.commandBufferOffset, cmd.drawCount, cmd.stride);
+        break;
+      }
+      case detail::CommandType::DRAW_INDEXED_INDIRECT_COUNT:
+      {
+        const auto& cmd = PayloadAs<CmdDrawIndirectCount>(payload);
+        Cmd::DrawIndexedIndirectCount(*cmd.commandBuffer,
+                                      cmd.commandBufferOffset,
+                                      *cmd.countBuffer,
+                                      cmd.countBufferOffset,
+                                      cmd.maxDrawCount,
+                                      cmd.stride);
+        break;
+      }
+      case detail::CommandType::BIND_VERTEX_BUFFER:
+      {
+        const auto& cmd = PayloadAs<CmdBindVertexBuffer>(payload);
+        Cmd::BindVertexBuffer(cmd.bindingIndex, *cmd.buffer, cmd.offset, cmd.stride);
+        break;
+      }
+      case detail::CommandType::BIND_INDEX_BUFFER:
+      {
+        const auto& cmd = PayloadAs<CmdBindIndexBuffer>(payload);
+        Cmd::BindIndexBuffer(*cmd.buffer, cmd.indexType);
+        break;
+      }
+      case detail::CommandType::BIND_UNIFORM_BUFFER:
+      {
+        const auto& cmd = PayloadAs<CmdBindBufferRange>(payload);
+        Cmd::BindUniformBuffer(cmd.index, *cmd.buffer, cmd.offset, cmd.size);
+        break;
+      }
+      case detail::CommandType::BIND_STORAGE_BUFFER:
+      {
+        const auto& cmd = PayloadAs<CmdBindBufferRange>(payload);
+        Cmd::BindStorageBuffer(cmd.index, *cmd.buffer, cmd.offset, cmd.size);
+        break;
+      }
+      case detail::CommandType::BIND_SAMPLED_IMAGE:
+      {
+        const auto& cmd = PayloadAs<CmdBindSampledImage>(payload);
+        Cmd::BindSampledImage(cmd.index, *cmd.texture, cmd.sampler);
+        break;
+      }
+      case detail::CommandType::BIND_IMAGE:
+      {
+        const auto& cmd = PayloadAs<CmdBindImage>(payload);
+        Cmd::BindImage(cmd.index, *cmd.texture, cmd.level);
+        break;
+      }
+      case detail::CommandType::BIND_GROUP:
+      {
+        const auto& cmd = PayloadAs<CmdBindGroup>(payload);
+        Cmd::BindGroup(*cmd.group);
+        break;
+      }
+      case detail::CommandType::DISPATCH:
+      {
+        const auto& cmd = PayloadAs<CmdDispatch>(payload);
+        Cmd::Dispatch(cmd.groupCountX, cmd.groupCountY, cmd.groupCountZ);
+        break;
+      }
+      case detail::CommandType::DISPATCH_INDIRECT:
+      {
+        const auto& cmd = PayloadAs<CmdDispatchIndirect>(payload);
+        Cmd::DispatchIndirect(*cmd.commandBuffer, cmd.commandBufferOffset);
+        break;
+      }
+      case detail::CommandType::MEMORY_BARRIER:
+        Cmd::MemoryBarrier(PayloadAs<CmdMemoryBarrier>(payload).accessBits);
+        break;
+      default: FWOG_UNREACHABLE; return;
+      }
+
+      cursor += header.size;
+    }
+  }
+
+  void ExecuteCommandLists(std::span<const CommandList* const> commandLists)
+  {
+    for (const auto* commandList : commandLists)
+    {
+      FWOG_ASSERT(commandList);
+      commandList->Execute();
+    }
+  }
+} // namespace Fwog
@@ -0,0 +1,251 @@
+#include <Fwog/Buffer.h>
+#include <Fwog/Common.h>
+#include <Fwog/DrawBucket.h>
+#include <Fwog/Pipeline.h>
+#include <Fwog/Rendering.h>
+#include <Fwog/detail/BindingStateTracker.h>
+#include <Fwog/detail/Hash.h>
+#include <array>
+#include <bit>
+#include <numeric>
+#include <utility>
+
+namespace Fwog
+{
+  namespace
+  {
+    constexpr uint32_t PIPELINE_BITS = 12;
+    constexpr uint32_t TEXTURE_SET_BITS = 18;
+    constexpr uint32_t GEOMETRY_BITS = 18;
+    constexpr uint32_t DEPTH_BITS = 16;
+    static_assert(PIPELINE_BITS + TEXTURE_SET_BITS + GEOMETRY_BITS + DEPTH_BITS == 64);
+
+    // ids are handed out in order of first appearance in a frame, so they remain small
+    uint32_t GetOrAssignId(std::unordered_map<uint64_t, uint32_t>& ids, uint64_t key)
+    {
+      return ids.try_emplace(key, static_cast<uint32_t>(ids.size())).first->second;
+    }
+
+    uint64_t Field(uint32_t value, uint32_t bits, uint32_t shift)
+    {
+      // ids that do not fit wrap around, which only makes sorting less effective
+      return (static_cast<uint64_t>(value) & ((uint64_t(1) << bits) - 1)) << shift;
+    }
+
+    // the bit pattern of a non-negative float increases monotonically with its value
+    uint32_t DepthBucket(float depth)
+    {
+      FWOG_ASSERT(depth >= 0);
+      // -0.0f has the sign bit set, which would put it in the last bucket
+      depth += 0.0f;
+      return std::bit_cast<uint32_t>(depth) >> (32 - DEPTH_BITS);
+    }
+
+    uint64_t HashGeometry(const DrawItem& item)
+    {
+      size_t hash = 0;
+      detail::hashing::hash_combine(hash, item.vertexBuffer ? item.vertexBuffer->Handle() : 0u);
+      detail::hashing::hash_combine(hash, item.vertexBufferOffset);
+      detail::hashing::hash_combine(hash, item.vertexStride);
+      detail::hashing::hash_combine(hash, item.indexBuffer ? item.indexBuffer->Handle() : 0u);
+      detail::hashing::hash_combine(hash, static_cast<uint32_t>(item.indexType));
+      return hash;
+    }
+
+    bool SameGeometry(const DrawItem& a, const DrawItem& b)
+    {
+      return a.vertexBuffer == b.vertexBuffer && a.vertexBufferOffset == b.vertexBufferOffset &&
+             a.vertexStride == b.vertexStride && a.indexBuffer == b.indexBuffer && a.indexType == b.indexType;
+    }
+
+    uint64_t HashTextureSet(std::span<const DrawTextureBinding> textures)
+    {
+      size_t hash = 0;
+      for (const auto& binding : textures)
+      {
+        detail::hashing::hash_combine(hash, binding.index);
+        detail::hashing::hash_combine(hash, binding.texture->Handle());
+        detail::hashing::hash_combine(hash, binding.sampler.Handle());
+      }
+      return hash;
+    }
+  } // namespace
+
+  void DrawBucket::Submit(const DrawItem& draw)
+  {
+    FWOG_ASSERT(draw.pipeline);
+
+    draws_.push_back({
+      .item = draw,
+      .firstTexture = static_cast<uint32_t>(textures_.size()),
+      .textureCount = static_cast<uint32_t>(draw.textures.size()),
+      .geometryHash = HashGeometry(draw),
+      .textureSetHash = HashTextureSet(draw.textures),
+    });
+    draws_.back().item.textures = {};
+    textures_.insert(textures_.end(), draw.textures.begin(), draw.textures.end());
+  }
+
+  DrawBucketStats DrawBucket::Flush()
+  {
+    const auto drawCount = static_cast<uint32_t>(draws_.size());
+
+    keys_.resize(drawCount);
+    for (uint32_t i = 0; i < drawCount; i++)
+    {
+      const auto& draw = draws_[i];
+      const uint32_t pipelineId = GetOrAssignId(pipelineIds_, draw.item.pipeline->Handle());
+      const uint32_t textureSetId = GetOrAssignId(textureSetIds_, draw.textureSetHash);
+      const uint32_t geometryId = GetOrAssignId(geometryIds_, draw.geometryHash);
+
+      keys_[i] = Field(pipelineId, PIPELINE_BITS, TEXTURE_SET_BITS + GEOMETRY_BITS + DEPTH_BITS) |
+                 Field(textureSetId, TEXTURE_SET_BITS, GEOMETRY_BITS + DEPTH_BITS) |
+                 Field(geometryId, GEOMETRY_BITS, DEPTH_BITS) | Field(DepthBucket(draw.item.depth), DEPTH_BITS, 0);
+    }
+
+    order_.resize(drawCount);
+    std::iota(order_.begin(), order_.end(), 0u);
+    const auto unsorted = Issue(order_, false);
+
+    SortKeys();
+    const auto sorted = Issue(order_, true);
+
+    DrawBucketStats stats{
+      .drawCount = drawCount,
+      .pipelineChanges = sorted.pipeline,
+      .geometryChanges = sorted.geometry,
+      .textureChanges = sorted.texture,
+      .unsortedPipelineChanges = unsorted.pipeline,
+      .unsortedGeometryChanges = unsorted.geometry,
+      .unsortedTextureChanges = unsorted.texture,
+    };
+
+    Clear();
+    return stats;
+  }
+
+  void DrawBucket::Clear()
+  {
+    draws_.clear();
+    textures_.clear();
+    pipelineIds_.clear();
+    geometryIds_.clear();
+    textureSetIds_.clear();
+  }
+
+  // LSD radix sort of (key, index) pairs, one byte per pass. Passes where every key has the same digit are skipped.
+  void DrawBucket::SortKeys()
+  {
+    const size_t count = keys_.size();
+    scratchKeys_.resize(count);
+    scratchOrder_.resize(count);
+
+    for (uint32_t shift = 0; shift < 64; shift += 8)
+    {
+      std::array<uint32_t, 256> histogram{};
+      for (size_t i = 0; i < count; i++)
+      {
+        histogram[(keys_[i] >> shift) & 0xFF]++;
+      }
+
+      if (count == 0 || histogram[(keys_[0] >> shift) & 0xFF] == count)
+      {
+        continue;
+      }
+
+      uint32_t sum = 0;
+      for (auto& bucket : histogram)
+      {
+        sum += std::exchange(bucket, sum);
+      }
+
+      for (size_t i = 0; i < count; i++)
+      {
+        const uint32_t dst = histogram[(keys_[i] >> shift) & 0xFF]++;
+        scratchKeys_[dst] = keys_[i];
+        scratchOrder_[dst] = order_[i];
+      }
+
+      keys_.swap(scratchKeys_);
+      order_.swap(scratchOrder_);
+    }
+  }
+
+  DrawBucket::StateChangeCounts DrawBucket::Issue(std::span<const uint32_t> order, bool execute) const
+  {
+    StateChangeCounts counts{};
+
+    uint64_t lastPipeline = 0;
+    const DrawItem* lastGeometry = nullptr;
+    std::array<std::pair<uint32_t, uint32_t>, detail::MAX_TRACKED_TEXTURE_UNITS> lastTextures{};
+
+    for (uint32_t index : order)
+    {
+      const auto& draw = draws_[index];
+      const auto& item = draw.item;
+
+      if (item.pipeline->Handle() != lastPipeline)
+      {
+        lastPipeline = item.pipeline->Handle();
+        // the new pipeline may use a different vertex array, which has its own buffer bindings
+        lastGeometry = nullptr;
+        counts.pipeline++;
+        if (execute)
+        {
+          Cmd::BindGraphicsPipeline(*item.pipeline);
+        }
+      }
+
+      for (uint32_t i = draw.firstTexture; i < draw.firstTexture + draw.textureCount; i++)
+      {
+        const auto& binding = textures_[i];
+        const auto state = std::make_pair(binding.texture->Handle(), binding.sampler.Handle());
+        if (binding.index < detail::MAX_TRACKED_TEXTURE_UNITS)
+        {
+          if (lastTextures[binding.index] == state)
+          {
+            continue;
+          }
+          lastTextures[binding.index] = state;
+        }
+
+        counts.texture++;
+        if (execute)
+        {
+          Cmd::BindSampledImage(binding.index, *binding.texture, binding.sampler);
+        }
+      }
+
+      if (!lastGeometry || !SameGeometry(*lastGeometry, item))
+      {
+        lastGeometry = &item;
+        counts.geometry++;
+        if (execute)
+        {
+          if (item.vertexBuffer)
+          {
+            Cmd::BindVertexBuffer(0, *item.vertexBuffer, item.vertexBufferOffset, item.vertexStride);
+          }
+          if (item.indexBuffer)
+          {
+            Cmd::BindIndexBuffer(*item.indexBuffer, item.indexType);
+          }
+        }
+      }
+
+      if (execute)
+      {
+        if (item.indexBuffer)
+        {
+          Cmd::DrawIndexed(item.count, item.instanceCount, item.firstIndex, item.vertexOffset, item.firstInstance);
+        }
+        else
+        {
+          Cmd::Draw(item.count, item.instanceCount, item.firstVertex, item.firstInstance);
+        }
+      }
+    }
+
+    return counts;
+  }
+} // namespace Fwog
@@ -42,7 +42,7 @@ namespace Fwog
     GLenum result = glClientWaitSync(reinterpret_cast<GLsync>(sync_),
                                      GL_SYNC_FLUSH_COMMANDS_BIT,
                                      std::numeric_limits<GLuint64>::max());
-    FWOG_ASSERT(result == GL_CONDITION_SATISFIED);
+    FWOG_ASSERT(result == GL_CONDITION_SATISFIED || result == GL_ALREADY_SIGNALED);
     glEndQuery(GL_TIME_ELAPSED);
     uint64_t elapsed;
     glGetQueryObjectui64v(id, GL_QUERY_RESULT, &elapsed);
@@ -50,4 +50,19 @@ namespace Fwog
     this->~Fence();
     return elapsed;
   }
+
+  void Fence::WaitUntilSignaled()
+  {
+    FWOG_ASSERT(sync_ != nullptr);
+    auto sync = reinterpret_cast<GLsync>(sync_);
+
+    // poll first, since the fence is usually signaled by the time it is waited on
+    GLenum result = glClientWaitSync(sync, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED)
+    {
+      result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, std::numeric_limits<GLuint64>::max());
+    }
+    FWOG_ASSERT(result == GL_CONDITION_SATISFIED || result == GL_ALREADY_SIGNALED);
+    this->~Fence();
+  }
 } // namespace Fwog
\ No newline at end of file
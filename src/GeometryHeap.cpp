@@ -0,0 +1,177 @@
+#include <Fwog/Common.h>
+#include <Fwog/GeometryHeap.h>
+#include <algorithm>
+#include <vector>
+
+namespace Fwog
+{
+  namespace
+  {
+    uint32_t GetIndexSize(IndexType indexType)
+    {
+      switch (indexType)
+      {
+      case IndexType::UNSIGNED_BYTE: return 1;
+      case IndexType::UNSIGNED_SHORT: return 2;
+      case IndexType::UNSIGNED_INT: return 4;
+      default: FWOG_UNREACHABLE; return 0;
+      }
+    }
+  } // namespace
+
+  GeometryHeap::GeometryHeap(const GeometryHeapCreateInfo& createInfo)
+      : createInfo_(createInfo),
+        indexSize_(GetIndexSize(createInfo.indexType)),
+        vertexBuffer_(size_t(createInfo.vertexStride) * createInfo.vertexCapacity, BufferStorageFlag::DYNAMIC_STORAGE),
+        indexBuffer_(size_t(indexSize_) * createInfo.indexCapacity, BufferStorageFlag::DYNAMIC_STORAGE),
+        vertexAllocator_(createInfo.vertexCapacity),
+        indexAllocator_(createInfo.indexCapacity)
+  {
+    FWOG_ASSERT(createInfo.vertexStride > 0 && createInfo.vertexCapacity > 0 && createInfo.indexCapacity > 0);
+    // vertex offsets are signed in draw commands
+    FWOG_ASSERT(createInfo.vertexCapacity <= static_cast<uint32_t>(INT32_MAX));
+  }
+
+  std::optional<uint64_t> GeometryHeap::Allocate(TriviallyCopyableByteSpan vertices, TriviallyCopyableByteSpan indices)
+  {
+    FWOG_ASSERT(!vertices.empty() && vertices.size_bytes() % createInfo_.vertexStride == 0);
+    FWOG_ASSERT(indices.size_bytes() % indexSize_ == 0);
+
+    Allocation allocation{
+      .vertexCount = static_cast<uint32_t>(vertices.size_bytes() / createInfo_.vertexStride),
+      .indexCount = static_cast<uint32_t>(indices.size_bytes() / indexSize_),
+    };
+
+    auto vertexRange = vertexAllocator_.Allocate(allocation.vertexCount);
+    if (!vertexRange)
+    {
+      return std::nullopt;
+    }
+    allocation.vertices = *vertexRange;
+
+    if (allocation.indexCount > 0)
+    {
+      auto indexRange = indexAllocator_.Allocate(allocation.indexCount);
+      if (!indexRange)
+      {
+        vertexAllocator_.Free(allocation.vertices.node);
+        return std::nullopt;
+      }
+      allocation.indices = *indexRange;
+      indexBuffer_.SubData(indices, size_t(indexSize_) * allocation.indices.offset);
+    }
+
+    vertexBuffer_.SubData(vertices, size_t(createInfo_.vertexStride) * allocation.vertices.offset);
+    return allocations_.Insert(allocation);
+  }
+
+  void GeometryHeap::Free(uint64_t allocation)
+  {
+    auto erased = allocations_.Erase(allocation);
+    FWOG_ASSERT(erased && "Tried to free a nonexistent allocation");
+    if (!erased)
+    {
+      return;
+    }
+
+    vertexAllocator_.Free(erased->vertices.node);
+    if (erased->indexCount > 0)
+    {
+      indexAllocator_.Free(erased->indices.node);
+    }
+  }
+
+  GeometryRange GeometryHeap::Range(uint64_t allocation) const
+  {
+    const auto* entry = allocations_.Get(allocation);
+    FWOG_ASSERT(entry);
+    return GeometryRange{
+      .vertexOffset = static_cast<int32_t>(entry->vertices.offset),
+      .vertexCount = entry->vertexCount,
+      .firstIndex = entry->indexCount > 0 ? entry->indices.offset : 0,
+      .indexCount = entry->indexCount,
+    };
+  }
+
+  DrawIndexedIndirectCommand GeometryHeap::DrawCommand(uint64_t allocation,
+                                                       uint32_t instanceCount,
+                                                       uint32_t firstInstance) const
+  {
+    const auto range = Range(allocation);
+    return DrawIndexedIndirectCommand{
+      .indexCount = range.indexCount,
+      .instanceCount = instanceCount,
+      .firstIndex = range.firstIndex,
+      .vertexOffset = range.vertexOffset,
+      .firstInstance = firstInstance,
+    };
+  }
+
+  void GeometryHeap::Defragment()
+  {
+    std::vector<Allocation*> live;
+    live.reserve(allocations_.Size());
+    allocations_.ForEach([&live](Allocation& allocation) { live.push_back(&allocation); });
+
+    // vertices and indices are each packed in the order of their current offsets, which can differ between the two
+    std::vector<Allocation*> indexed;
+    for (auto* allocation : live)
+    {
+      if (allocation->indexCount > 0)
+      {
+        indexed.push_back(allocation);
+      }
+    }
+    std::sort(live.begin(),
+              live.end(),
+              [](const Allocation* a, const Allocation* b) { return a->vertices.offset < b->vertices.offset; });
+    std::sort(indexed.begin(),
+              indexed.end(),
+              [](const Allocation* a, const Allocation* b) { return a->indices.offset < b->indices.offset; });
+
+    std::vector<uint32_t> vertexCounts;
+    std::vector<uint32_t> indexCounts;
+    for (const auto* allocation : live)
+    {
+      vertexCounts.push_back(allocation->vertexCount);
+    }
+    for (const auto* allocation : indexed)
+    {
+      indexCounts.push_back(allocation->indexCount);
+    }
+
+    // ranges that move can overlap their old location, so the geometry is copied to new buffers
+    Buffer vertexBuffer(vertexBuffer_.Size(), BufferStorageFlag::DYNAMIC_STORAGE);
+    Buffer indexBuffer(indexBuffer_.Size(), BufferStorageFlag::DYNAMIC_STORAGE);
+
+    // packing from the start always fits every range, while allocating them one by one can fail due to bin rounding
+    const auto packedVertices = vertexAllocator_.ResetPacked(vertexCounts);
+    const auto packedIndices = indexAllocator_.ResetPacked(indexCounts);
+
+    const size_t stride = createInfo_.vertexStride;
+    for (size_t i = 0; i < live.size(); i++)
+    {
+      auto* allocation = live[i];
+      glCopyNamedBufferSubData(vertexBuffer_.Handle(),
+                               vertexBuffer.Handle(),
+                               static_cast<GLintptr>(stride * allocation->vertices.offset),
+                               static_cast<GLintptr>(stride * packedVertices[i].offset),
+                               static_cast<GLsizeiptr>(stride * allocation->vertexCount));
+      allocation->vertices = packedVertices[i];
+    }
+
+    for (size_t i = 0; i < indexed.size(); i++)
+    {
+      auto* allocation = indexed[i];
+      glCopyNamedBufferSubData(indexBuffer_.Handle(),
+                               indexBuffer.Handle(),
+                               static_cast<GLintptr>(size_t(indexSize_) * allocation->indices.offset),
+                               static_cast<GLintptr>(size_t(indexSize_) * packedIndices[i].offset),
+                               static_cast<GLsizeiptr>(size_t(indexSize_) * allocation->indexCount));
+      allocation->indices = packedIndices[i];
+    }
+
+    vertexBuffer_ = std::move(vertexBuffer);
+    indexBuffer_ = std::move(indexBuffer);
+  }
+} // namespace Fwog
@@ -1,13 +1,145 @@
+#include <Fwog/Common.h>
 #include <Fwog/Pipeline.h>
+#include <Fwog/Rendering.h>
+#include <Fwog/Texture.h>
 #include <Fwog/detail/PipelineManager.h>
 
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace Fwog
 {
+  extern bool isRendering;
+  extern bool isComputeActive;
+
+  namespace
+  {
+    struct WarmupTargets
+    {
+      std::vector<Texture> colors;
+      std::optional<Texture> depth;
+      std::optional<Texture> depthStencil;
+    };
+
+    bool sWarmupEnabled = false;
+    std::vector<PipelineWarmupRecord> sWarmupRecords;
+
+    // Only freed when warm-up is disabled, since textures cannot be destroyed after the context is gone
+    WarmupTargets* sWarmupTargets = nullptr;
+
+    bool CanWarmup()
+    {
+      return sWarmupEnabled && !isRendering && !isComputeActive;
+    }
+
+    void WarmupGraphicsPipeline(const GraphicsPipeline& pipeline)
+    {
+      if (!CanWarmup())
+      {
+        return;
+      }
+
+      const auto* pipelineState = detail::GetGraphicsPipelineInternal(pipeline.Handle());
+      const auto& colorFormats = pipelineState->warmupColorFormats;
+      const size_t colorCount =
+        std::max({size_t(1), pipelineState->colorBlendState.attachments.size(), colorFormats.size()});
+      const bool usesStencil = pipelineState->stencilState.stencilTestEnable;
+
+      if (!sWarmupTargets)
+      {
+        sWarmupTargets = new WarmupTargets;
+      }
+
+      // targets are shared by pipelines that render to the same formats, but each attachment needs its own
+      auto& targets = *sWarmupTargets;
+      std::array<size_t, detail::MAX_COLOR_ATTACHMENTS> colorTargets{};
+      for (size_t i = 0; i < colorCount; i++)
+      {
+        const auto format = i < colorFormats.size() ? colorFormats[i] : Format::R8G8B8A8_UNORM;
+        size_t target = 0;
+        while (target < targets.colors.size() &&
+               (targets.colors[target].CreateInfo().format != format ||
+                std::find(colorTargets.begin(), colorTargets.begin() + i, target) != colorTargets.begin() + i))
+        {
+          target++;
+        }
+        if (target == targets.colors.size())
+        {
+          targets.colors.push_back(CreateTexture2D({1, 1}, format, "Pipeline warm-up color"));
+        }
+        colorTargets[i] = target;
+      }
+      if (!usesStencil && !targets.depth)
+      {
+        targets.depth = CreateTexture2D({1, 1}, Format::D32_FLOAT, "Pipeline warm-up depth");
+      }
+      if (usesStencil && !targets.depthStencil)
+      {
+        targets.depthStencil = CreateTexture2D({1, 1}, Format::D32_FLOAT_S8_UINT, "Pipeline warm-up depth stencil");
+      }
+
+      std::array<RenderAttachment, detail::MAX_COLOR_ATTACHMENTS> colorAttachments{};
+      for (size_t i = 0; i < colorCount; i++)
+      {
+        colorAttachments[i].texture = &targets.colors[colorTargets[i]];
+      }
+      const RenderAttachment depthAttachment{.texture = usesStencil ? &*targets.depthStencil : &*targets.depth};
+
+      const auto start = std::chrono::steady_clock::now();
+
+      BeginRendering({
+        .name = "Pipeline warm-up",
+        .colorAttachments = {colorAttachments.data(), colorCount},
+        .depthAttachment = &depthAttachment,
+        .stencilAttachment = usesStencil ? &depthAttachment : nullptr,
+      });
+      Cmd::BindGraphicsPipeline(pipeline);
+      Cmd::Draw(0, 1, 0, 0);
+      EndRendering();
+
+      // Drivers may defer compilation until the commands are submitted. Flushing submits them without waiting for
+      // the GPU, so only the CPU time the driver spends, which is what would have caused a hitch, is measured.
+      glFlush();
+
+      sWarmupRecords.push_back({
+        .name = pipelineState->name,
+        .pipeline = pipeline.Handle(),
+        .duration = std::chrono::steady_clock::now() - start,
+      });
+    }
+
+    void WarmupComputePipeline(const ComputePipeline& pipeline)
+    {
+      if (!CanWarmup())
+      {
+        return;
+      }
+
+      const auto start = std::chrono::steady_clock::now();
+
+      BeginCompute("Pipeline warm-up");
+      Cmd::BindComputePipeline(pipeline);
+      Cmd::Dispatch(0, 0, 0);
+      EndCompute();
+
+      glFlush();
+
+      sWarmupRecords.push_back({
+        .name = detail::GetComputePipelineInternal(pipeline.Handle())->name,
+        .pipeline = pipeline.Handle(),
+        .duration = std::chrono::steady_clock::now() - start,
+      });
+    }
+  } // namespace
+
   GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineInfo& info)
       : id_(detail::CompileGraphicsPipelineInternal(info))
   {
+    WarmupGraphicsPipeline(*this);
   }
 
   GraphicsPipeline::~GraphicsPipeline()
@@ -33,6 +165,12 @@ namespace Fwog
 
   ComputePipeline::ComputePipeline(const ComputePipelineInfo& info) : id_(detail::CompileComputePipelineInternal(info))
   {
+    WarmupComputePipeline(*this);
+  }
+
+  const PipelineReflection& GraphicsPipeline::Reflection() const
+  {
+    return *detail::GetGraphicsPipelineInternal(id_)->reflection;
   }
 
   ComputePipeline::~ComputePipeline()
@@ -54,4 +192,122 @@ namespace Fwog
     id_ = std::exchange(old.id_, 0);
     return *this;
   }
+
+  const PipelineReflection& ComputePipeline::Reflection() const
+  {
+    return *detail::GetComputePipelineInternal(id_)->reflection;
+  }
+
+  Extent3D ComputePipeline::WorkgroupSize() const
+  {
+    return Reflection().workgroupSize;
+  }
+
+  namespace
+  {
+    template<typename T>
+    uint32_t GetProgram(uint64_t pipeline)
+    {
+      if constexpr (std::is_same_v<T, GraphicsPipeline>)
+      {
+        return detail::GetGraphicsPipelineInternal(pipeline)->program;
+      }
+      else
+      {
+        return detail::GetComputePipelineInternal(pipeline)->program;
+      }
+    }
+  } // namespace
+
+  template<typename T>
+  PendingPipeline<T>::PendingPipeline(PendingPipeline&& old) noexcept : id_(std::exchange(old.id_, 0))
+  {
+  }
+
+  template<typename T>
+  PendingPipeline<T>& PendingPipeline<T>::operator=(PendingPipeline&& old) noexcept
+  {
+    if (this == &old)
+    {
+      return *this;
+    }
+
+    this->~PendingPipeline();
+    return *new (this) PendingPipeline(std::move(old));
+  }
+
+  template<typename T>
+  PendingPipeline<T>::~PendingPipeline()
+  {
+    if (id_ != 0)
+    {
+      // the result is not needed, so the pipeline is destroyed without waiting for it
+      T pipeline(id_);
+    }
+  }
+
+  template<typename T>
+  bool PendingPipeline<T>::IsReady() const
+  {
+    FWOG_ASSERT(id_ != 0);
+    return detail::IsProgramLinkCompleteInternal(GetProgram<T>(id_));
+  }
+
+  template<typename T>
+  T PendingPipeline<T>::Wait()
+  {
+    FWOG_ASSERT(id_ != 0);
+
+    // the pipeline is destroyed if checking the status throws
+    T pipeline(std::exchange(id_, 0));
+    detail::CheckProgramLinkStatusInternal(GetProgram<T>(pipeline.Handle()));
+
+    if constexpr (std::is_same_v<T, GraphicsPipeline>)
+    {
+      detail::ReflectGraphicsPipelineInternal(pipeline.Handle());
+      WarmupGraphicsPipeline(pipeline);
+    }
+    else
+    {
+      detail::ReflectComputePipelineInternal(pipeline.Handle());
+      WarmupComputePipeline(pipeline);
+    }
+
+    return pipeline;
+  }
+
+  template class PendingPipeline<GraphicsPipeline>;
+  template class PendingPipeline<ComputePipeline>;
+
+  PendingPipeline<GraphicsPipeline> CompileGraphicsPipelineAsync(const GraphicsPipelineInfo& info)
+  {
+    detail::EnableParallelCompilationInternal();
+    return PendingPipeline<GraphicsPipeline>(detail::CompileGraphicsPipelineInternal(info, true));
+  }
+
+  PendingPipeline<ComputePipeline> CompileComputePipelineAsync(const ComputePipelineInfo& info)
+  {
+    detail::EnableParallelCompilationInternal();
+    return PendingPipeline<ComputePipeline>(detail::CompileComputePipelineInternal(info, true));
+  }
+
+  void SetPipelineWarmupEnabled(bool enabled)
+  {
+    sWarmupEnabled = enabled;
+    if (!enabled)
+    {
+      delete sWarmupTargets;
+      sWarmupTargets = nullptr;
+    }
+  }
+
+  std::span<const PipelineWarmupRecord> GetPipelineWarmupRecords()
+  {
+    return sWarmupRecords;
+  }
+
+  void ClearPipelineWarmupRecords()
+  {
+    sWarmupRecords.clear();
+  }
 } // namespace Fwog
\ No newline at end of file
@@ -0,0 +1,342 @@
+#include <Fwog/Common.h>
+#include <Fwog/PipelineCache.h>
+#include <Fwog/detail/Hash.h>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Fwog
+{
+  namespace
+  {
+    PipelineCache* sPipelineCache = nullptr;
+
+    constexpr uint32_t FILE_MAGIC = 0x43505746; // "FWPC"
+    constexpr uint32_t FILE_VERSION = 2;
+
+    // file layout: FileHeader, FileEntry[entryCount], binaries
+    struct FileHeader
+    {
+      uint32_t magic;
+      uint32_t version;
+      uint64_t driverHash;
+      uint64_t entryCount;
+    };
+
+    struct FileEntry
+    {
+      PipelineCacheKey key;
+      uint32_t binaryFormat;
+      uint32_t binarySize;
+      uint64_t offset;
+    };
+
+    // returns null if the file does not exist or cannot be mapped
+    const std::byte* MapFile(const std::string& path, size_t& outSize)
+    {
+#ifdef _WIN32
+      HANDLE file =
+        CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+      if (file == INVALID_HANDLE_VALUE)
+      {
+        return nullptr;
+      }
+
+      LARGE_INTEGER size{};
+      if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+      {
+        CloseHandle(file);
+        return nullptr;
+      }
+
+      HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      CloseHandle(file);
+      if (!mapping)
+      {
+        return nullptr;
+      }
+
+      // the view keeps the mapping alive
+      void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(mapping);
+      if (!data)
+      {
+        return nullptr;
+      }
+
+      outSize = static_cast<size_t>(size.QuadPart);
+      return static_cast<const std::byte*>(data);
+#else
+      int fd = open(path.c_str(), O_RDONLY);
+      if (fd < 0)
+      {
+        return nullptr;
+      }
+
+      struct stat fileStat{};
+      if (fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+      {
+        close(fd);
+        return nullptr;
+      }
+
+      // the mapping stays valid after the descriptor is closed
+      void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      close(fd);
+      if (data == MAP_FAILED)
+      {
+        return nullptr;
+      }
+
+      outSize = static_cast<size_t>(fileStat.st_size);
+      return static_cast<const std::byte*>(data);
+#endif
+    }
+
+    void UnmapFile(const std::byte* data, [[maybe_unused]] size_t size)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile(data);
+#else
+      munmap(const_cast<std::byte*>(data), size);
+#endif
+    }
+
+    uint64_t HashDriver()
+    {
+      uint64_t hash = detail::hashing::fnv1a(nullptr, 0);
+      for (GLenum name : {GL_VENDOR, GL_RENDERER, GL_VERSION})
+      {
+        if (const auto* string = reinterpret_cast<const char*>(glGetString(name)))
+        {
+          // include the terminator so the strings cannot run together
+          hash = detail::hashing::fnv1a(string, std::strlen(string) + 1, hash);
+        }
+      }
+      return hash;
+    }
+  } // namespace
+
+  size_t PipelineCache::KeyHash::operator()(const PipelineCacheKey& key) const noexcept
+  {
+    size_t hash = 0;
+    detail::hashing::hash_combine(hash, key.shaderHashes[0]);
+    detail::hashing::hash_combine(hash, key.shaderHashes[1]);
+    return hash;
+  }
+
+  PipelineCache::PipelineCache(std::string_view path) : path_(path), driverHash_(HashDriver())
+  {
+    GLint formatCount{};
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    supported_ = formatCount > 0;
+
+    if (supported_)
+    {
+      Load();
+    }
+  }
+
+  PipelineCache::~PipelineCache()
+  {
+    if (sPipelineCache == this)
+    {
+      sPipelineCache = nullptr;
+    }
+
+    Unmap();
+  }
+
+  // Adds the entries of the cache file. Entries that are already present take precedence.
+  void PipelineCache::Load()
+  {
+    FWOG_ASSERT(!mappedData_);
+
+    size_t size{};
+    const std::byte* data = MapFile(path_, size);
+    if (!data)
+    {
+      return;
+    }
+
+    mappedData_ = data;
+    mappedSize_ = size;
+
+    FileHeader header{};
+    if (size < sizeof(FileHeader))
+    {
+      Unmap();
+      return;
+    }
+
+    std::memcpy(&header, data, sizeof(FileHeader));
+    if (header.magic != FILE_MAGIC || header.version != FILE_VERSION || header.driverHash != driverHash_ ||
+        header.entryCount > (size - sizeof(FileHeader)) / sizeof(FileEntry))
+    {
+      Unmap();
+      return;
+    }
+
+    for (uint64_t i = 0; i < header.entryCount; i++)
+    {
+      FileEntry fileEntry{};
+      std::memcpy(&fileEntry, data + sizeof(FileHeader) + i * sizeof(FileEntry), sizeof(FileEntry));
+      if (fileEntry.offset > size || fileEntry.binarySize > size - fileEntry.offset)
+      {
+        continue;
+      }
+
+      entries_.try_emplace(fileEntry.key,
+                           Entry{
+                             .binaryFormat = fileEntry.binaryFormat,
+                             .binary = {data + fileEntry.offset, fileEntry.binarySize},
+                           });
+    }
+  }
+
+  void PipelineCache::Unmap()
+  {
+    if (mappedData_)
+    {
+      UnmapFile(mappedData_, mappedSize_);
+      mappedData_ = nullptr;
+      mappedSize_ = 0;
+    }
+  }
+
+  bool PipelineCache::Save()
+  {
+    if (!supported_)
+    {
+      return false;
+    }
+
+    std::vector<std::byte> file(sizeof(FileHeader) + entries_.size() * sizeof(FileEntry));
+    const FileHeader header{
+      .magic = FILE_MAGIC,
+      .version = FILE_VERSION,
+      .driverHash = driverHash_,
+      .entryCount = entries_.size(),
+    };
+    std::memcpy(file.data(), &header, sizeof(FileHeader));
+
+    size_t i = 0;
+    for (const auto& [key, entry] : entries_)
+    {
+      const FileEntry fileEntry{
+        .key = key,
+        .binaryFormat = entry.binaryFormat,
+        .binarySize = static_cast<uint32_t>(entry.binary.size()),
+        .offset = file.size(),
+      };
+      std::memcpy(file.data() + sizeof(FileHeader) + i++ * sizeof(FileEntry), &fileEntry, sizeof(FileEntry));
+      file.insert(file.end(), entry.binary.begin(), entry.binary.end());
+    }
+
+    // write to a temporary file first so a failed write cannot corrupt the existing cache
+    const auto tempPath = path_ + ".tmp";
+    {
+      std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+      stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+      if (!stream)
+      {
+        return false;
+      }
+    }
+
+    // the old file must be unmapped before it can be replaced, so entries that point into it are re-read afterwards
+    Unmap();
+    std::erase_if(entries_, [](const auto& pair) { return pair.second.owned.empty(); });
+
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path_, ec);
+    if (!ec)
+    {
+      entries_.clear();
+    }
+    else
+    {
+      std::filesystem::remove(tempPath, ec);
+    }
+
+    Load();
+    return !ec;
+  }
+
+  uint32_t PipelineCache::LoadProgram(const PipelineCacheKey& key)
+  {
+    auto it = entries_.find(key);
+    if (it == entries_.end())
+    {
+      misses_++;
+      return 0;
+    }
+
+    const auto& entry = it->second;
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, entry.binaryFormat, entry.binary.data(), static_cast<GLsizei>(entry.binary.size()));
+
+    // drivers reject binaries from other driver builds or hardware, which is not an error
+    GLint success{};
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+      glDeleteProgram(program);
+      entries_.erase(it);
+      misses_++;
+      return 0;
+    }
+
+    hits_++;
+    return program;
+  }
+
+  void PipelineCache::StoreProgram(const PipelineCacheKey& key, uint32_t program)
+  {
+    if (!supported_)
+    {
+      return;
+    }
+
+    GLint length{};
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+    {
+      return;
+    }
+
+    Entry entry{};
+    entry.owned.resize(static_cast<size_t>(length));
+    GLenum format{};
+    glGetProgramBinary(program, length, nullptr, &format, entry.owned.data());
+    entry.binaryFormat = format;
+    entry.binary = entry.owned;
+    entries_.insert_or_assign(key, std::move(entry));
+  }
+
+  void SetPipelineCache(PipelineCache* cache)
+  {
+    sPipelineCache = cache;
+  }
+
+  PipelineCache* GetPipelineCache()
+  {
+    return sPipelineCache;
+  }
+} // namespace Fwog
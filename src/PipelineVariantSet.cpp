@@ -0,0 +1,106 @@
+#include <Fwog/Common.h>
+#include <Fwog/PipelineVariantSet.h>
+#include <Fwog/Shader.h>
+#include <Fwog/ShaderSourceLoader.h>
+#include <optional>
+#include <utility>
+
+namespace Fwog
+{
+  PipelineVariantSet::PipelineVariantSet(const PipelineVariantSetInfo& info)
+      : name_(info.baseInfo.name),
+        vertexBindingDescriptions_(info.baseInfo.vertexInputState.vertexBindingDescriptions.begin(),
+                                   info.baseInfo.vertexInputState.vertexBindingDescriptions.end()),
+        colorBlendAttachments_(info.baseInfo.colorBlendState.attachments.begin(),
+                               info.baseInfo.colorBlendState.attachments.end()),
+        warmupColorFormats_(info.baseInfo.warmupColorFormats.begin(), info.baseInfo.warmupColorFormats.end()),
+        baseInfo_(info.baseInfo),
+        sourceLoader_(info.sourceLoader),
+        vertexShaderPath_(info.vertexShaderPath),
+        fragmentShaderPath_(info.fragmentShaderPath),
+        maxResidentVariants_(info.maxResidentVariants)
+  {
+    FWOG_ASSERT(sourceLoader_ && "A shader source loader is required");
+    FWOG_ASSERT(maxResidentVariants_ > 0);
+
+    // the base info may refer to memory owned by the caller
+    baseInfo_.name = name_;
+    baseInfo_.vertexShader = nullptr;
+    baseInfo_.fragmentShader = nullptr;
+    baseInfo_.vertexInputState.vertexBindingDescriptions = vertexBindingDescriptions_;
+    baseInfo_.colorBlendState.attachments = colorBlendAttachments_;
+    baseInfo_.warmupColorFormats = warmupColorFormats_;
+
+    for (const auto& option : info.options)
+    {
+      FWOG_ASSERT(option.valueCount > 0);
+      optionNames_.emplace_back(option.name);
+      optionValueCounts_.push_back(option.valueCount);
+      possibleVariantCount_ *= option.valueCount;
+    }
+  }
+
+  const GraphicsPipeline& PipelineVariantSet::Get(std::span<const uint32_t> optionValues)
+  {
+    FWOG_ASSERT(optionValues.size() == optionValueCounts_.size());
+
+    // mixed-radix index of the variant
+    uint64_t key = 0;
+    for (size_t i = 0; i < optionValues.size(); i++)
+    {
+      FWOG_ASSERT(optionValues[i] < optionValueCounts_[i]);
+      key = key * optionValueCounts_[i] + optionValues[i];
+    }
+
+    usedVariants_.insert(key);
+
+    if (auto it = residentVariantIndices_.find(key); it != residentVariantIndices_.end())
+    {
+      residentVariants_.splice(residentVariants_.begin(), residentVariants_, it->second);
+      return it->second->pipeline;
+    }
+
+    // compile before evicting so a failed compile leaves the resident variants intact
+    auto pipeline = Compile(key, optionValues);
+
+    if (residentVariants_.size() >= maxResidentVariants_)
+    {
+      residentVariantIndices_.erase(residentVariants_.back().key);
+      residentVariants_.pop_back();
+    }
+
+    residentVariants_.push_front({key, std::move(pipeline)});
+    residentVariantIndices_.emplace(key, residentVariants_.begin());
+    return residentVariants_.front().pipeline;
+  }
+
+  GraphicsPipeline PipelineVariantSet::Compile(uint64_t key, std::span<const uint32_t> optionValues)
+  {
+    std::vector<std::string> values;
+    values.reserve(optionValues.size());
+    std::vector<ShaderDefine> defines;
+    defines.reserve(optionValues.size());
+    for (size_t i = 0; i < optionValues.size(); i++)
+    {
+      values.push_back(std::to_string(optionValues[i]));
+      defines.push_back({.name = optionNames_[i], .value = values.back()});
+    }
+
+    auto vertexShader = Shader(PipelineStage::VERTEX_SHADER, sourceLoader_->Load(vertexShaderPath_, defines).source);
+
+    std::optional<Shader> fragmentShader;
+    if (!fragmentShaderPath_.empty())
+    {
+      fragmentShader.emplace(PipelineStage::FRAGMENT_SHADER, sourceLoader_->Load(fragmentShaderPath_, defines).source);
+    }
+
+    const auto name = name_ + " (variant " + std::to_string(key) + ")";
+    auto info = baseInfo_;
+    info.name = name;
+    info.vertexShader = &vertexShader;
+    info.fragmentShader = fragmentShader ? &*fragmentShader : nullptr;
+
+    compiles_++;
+    return GraphicsPipeline(info);
+  }
+} // namespace Fwog
@@ -4,6 +4,7 @@
 #include <Fwog/Rendering.h>
 #include <Fwog/Texture.h>
 #include <Fwog/detail/ApiToEnum.h>
+#include <Fwog/detail/BindingStateTracker.h>
 #include <Fwog/detail/FramebufferCache.h>
 #include <Fwog/detail/PipelineManager.h>
 #include <Fwog/detail/VertexArrayCache.h>
@@ -24,6 +25,38 @@ static void GLEnableOrDisable(GLenum state, GLboolean value)
     glDisable(state);
 }
 
+// invalidates the whole framebuffer if possible, since drivers may not recognize a sub-rectangle that covers it
+static void InvalidateFramebuffer(GLuint fbo,
+                                  std::span<const GLenum> attachments,
+                                  const Fwog::Rect2D& area,
+                                  bool areaCoversFramebuffer)
+{
+  if (attachments.empty())
+    return;
+
+  if (areaCoversFramebuffer)
+  {
+    glInvalidateNamedFramebufferData(fbo, static_cast<GLsizei>(attachments.size()), attachments.data());
+  }
+  else
+  {
+    glInvalidateNamedFramebufferSubData(fbo,
+                                        static_cast<GLsizei>(attachments.size()),
+                                        attachments.data(),
+                                        area.offset.x,
+                                        area.offset.y,
+                                        area.extent.width,
+                                        area.extent.height);
+  }
+}
+
+// size of the mip level that is rendered to
+static Fwog::Extent2D GetAttachmentExtent(const Fwog::RenderAttachment& attachment)
+{
+  const auto& extent = attachment.texture->CreateInfo().extent;
+  return {std::max(extent.width >> attachment.level, 1u), std::max(extent.height >> attachment.level, 1u)};
+}
+
 static size_t GetIndexSize(Fwog::IndexType indexType)
 {
   switch (indexType)
@@ -39,7 +72,6 @@ namespace Fwog
 {
   // rendering cannot be suspended/resumed, nor done on multiple threads
   // since only one rendering instance can be active at a time, we store some state here
-  constexpr int MAX_COLOR_ATTACHMENTS = 8;
   bool isComputeActive = false;
   bool isRendering = false;
   bool isIndexBufferBound = false;
@@ -47,28 +79,44 @@ namespace Fwog
   bool isScopedDebugGroupPushed = false;
   bool isPipelineDebugGroupPushed = false;
 
-  // TODO: way to reset this pointer in case the user wants to do their own OpenGL operations (invalidate the cache).
-  // A shared_ptr is needed as the user can delete pipelines at any time, but we need to ensure it stays alive until
-  // the next pipeline is bound.
-  std::shared_ptr<const detail::GraphicsPipelineInfoOwning> sLastGraphicsPipeline{};
+  // TODO: way to reset this in case the user wants to do their own OpenGL operations (invalidate the cache).
+  // State group ids of the last bound pipeline. Ids are never reused, so this remains valid after the pipeline is
+  // destroyed.
+  detail::GraphicsPipelineStateBlock sLastStateBlock{};
   const RenderInfo* sLastRenderInfo{};
 
   // these can be set at the start of rendering, so they need to be tracked separately from the other pipeline state
-  std::array<ColorComponentFlags, MAX_COLOR_ATTACHMENTS> sLastColorMask = {};
+  std::array<ColorComponentFlags, detail::MAX_COLOR_ATTACHMENTS> sLastColorMask = {};
   bool sLastDepthMask = true;
   uint32_t sLastStencilMask[2] = {static_cast<uint32_t>(-1), static_cast<uint32_t>(-1)};
+  // the minimum value of GL_MAX_VIEWPORTS
+  constexpr size_t MAX_VIEWPORTS = 16;
+
+  // set when the viewport or scissor state is unknown, e.g. after setting individual viewports
   bool sInitViewport = true;
+  bool sInitScissor = true;
   Viewport sLastViewport = {};
   Rect2D sLastScissor = {};
   bool sScissorEnabled = false;
 
   PrimitiveTopology sTopology{};
   IndexType sIndexType{};
-  GLuint sVao = 0;
+  detail::VertexArrayState* sVertexArray = nullptr;
   GLuint sFbo = 0;
 
+  // attachments of the current rendering scope with AttachmentStoreOp::DONT_CARE, invalidated by EndRendering
+  std::array<GLenum, detail::MAX_COLOR_ATTACHMENTS + 2> sStoreInvalidateAttachments{};
+  size_t sStoreInvalidateCount = 0;
+  Rect2D sRenderArea = {};
+  bool sRenderAreaCoversFramebuffer = false;
+
+  // resolve textures of the current rendering scope's attachments, or null
+  std::array<const Texture*, detail::MAX_COLOR_ATTACHMENTS> sColorResolveTextures{};
+  const Texture* sDepthResolveTexture = nullptr;
+  const Texture* sStencilResolveTexture = nullptr;
+
   detail::FramebufferCache sFboCache;
-  detail::VertexArrayCache sVaoCache;
+  detail::BindingStateTracker sBindingTracker;
 
   void BeginSwapchainRendering(const SwapchainRenderInfo& renderInfo)
   {
@@ -162,7 +210,7 @@ namespace Fwog
     for (GLint i = 0; i < static_cast<GLint>(ri.colorAttachments.size()); i++)
     {
       const auto& attachment = ri.colorAttachments[i];
-      if (attachment.clearOnLoad)
+      if (attachment.loadOp == AttachmentLoadOp::CLEAR)
       {
         FWOG_ASSERT(std::holds_alternative<ClearColorValue>(attachment.clearValue));
 
@@ -197,8 +245,9 @@ namespace Fwog
       }
     }
 
-    if (ri.depthAttachment && ri.depthAttachment->clearOnLoad && ri.stencilAttachment &&
-        ri.stencilAttachment->clearOnLoad)
+    const bool clearDepthOnLoad = ri.depthAttachment && ri.depthAttachment->loadOp == AttachmentLoadOp::CLEAR;
+    const bool clearStencilOnLoad = ri.stencilAttachment && ri.stencilAttachment->loadOp == AttachmentLoadOp::CLEAR;
+    if (clearDepthOnLoad && clearStencilOnLoad)
     {
       // clear depth and stencil simultaneously
       FWOG_ASSERT(std::holds_alternative<ClearDepthStencilValue>(ri.depthAttachment->clearValue));
@@ -224,8 +273,7 @@ namespace Fwog
                                 clearDepth.depth,
                                 clearStencil.stencil);
     }
-    else if ((ri.depthAttachment && ri.depthAttachment->clearOnLoad) &&
-             (!ri.stencilAttachment || !ri.stencilAttachment->clearOnLoad))
+    else if (clearDepthOnLoad)
     {
       // clear just depth
       FWOG_ASSERT(std::holds_alternative<ClearDepthStencilValue>(ri.depthAttachment->clearValue));
@@ -239,8 +287,7 @@ namespace Fwog
 
       glClearNamedFramebufferfv(sFbo, GL_DEPTH, 0, &clearDepth.depth);
     }
-    else if ((ri.stencilAttachment && ri.stencilAttachment->clearOnLoad) &&
-             (!ri.depthAttachment || !ri.depthAttachment->clearOnLoad))
+    else if (clearStencilOnLoad)
     {
       // clear just stencil
       FWOG_ASSERT(std::holds_alternative<ClearDepthStencilValue>(ri.stencilAttachment->clearValue));
@@ -271,21 +318,18 @@ namespace Fwog
                       .extent = {std::numeric_limits<uint32_t>::max(), std::numeric_limits<uint32_t>::max()}};
       for (const auto& attachment : ri.colorAttachments)
       {
-        drawRect.extent.width = std::min(drawRect.extent.width, attachment.texture->CreateInfo().extent.width);
-        drawRect.extent.height = std::min(drawRect.extent.height, attachment.texture->CreateInfo().extent.height);
+        drawRect.extent.width = std::min(drawRect.extent.width, GetAttachmentExtent(attachment).width);
+        drawRect.extent.height = std::min(drawRect.extent.height, GetAttachmentExtent(attachment).height);
       }
       if (ri.depthAttachment)
       {
-        drawRect.extent.width = std::min(drawRect.extent.width, ri.depthAttachment->texture->CreateInfo().extent.width);
-        drawRect.extent.height =
-            std::min(drawRect.extent.height, ri.depthAttachment->texture->CreateInfo().extent.height);
+        drawRect.extent.width = std::min(drawRect.extent.width, GetAttachmentExtent(*ri.depthAttachment).width);
+        drawRect.extent.height = std::min(drawRect.extent.height, GetAttachmentExtent(*ri.depthAttachment).height);
       }
       if (ri.stencilAttachment)
       {
-        drawRect.extent.width =
-            std::min(drawRect.extent.width, ri.stencilAttachment->texture->CreateInfo().extent.width);
-        drawRect.extent.height =
-            std::min(drawRect.extent.height, ri.stencilAttachment->texture->CreateInfo().extent.height);
+        drawRect.extent.width = std::min(drawRect.extent.width, GetAttachmentExtent(*ri.stencilAttachment).width);
+        drawRect.extent.height = std::min(drawRect.extent.height, GetAttachmentExtent(*ri.stencilAttachment).height);
       }
       viewport.drawRect = drawRect;
     }
@@ -304,6 +348,127 @@ namespace Fwog
 
     sLastViewport = viewport;
     sInitViewport = false;
+
+    // contents outside the render area are preserved, so only the render area is invalidated
+    sRenderArea = viewport.drawRect;
+    sRenderAreaCoversFramebuffer = sRenderArea.offset.x == 0 && sRenderArea.offset.y == 0;
+    std::array<GLenum, detail::MAX_COLOR_ATTACHMENTS + 2> loadInvalidateAttachments{};
+    size_t loadInvalidateCount = 0;
+    sStoreInvalidateCount = 0;
+    auto addInvalidatedAttachment = [&](const RenderAttachment& attachment, GLenum glAttachment)
+    {
+      const auto extent = GetAttachmentExtent(attachment);
+      sRenderAreaCoversFramebuffer &=
+        sRenderArea.extent.width >= extent.width && sRenderArea.extent.height >= extent.height;
+      if (attachment.loadOp == AttachmentLoadOp::DONT_CARE)
+      {
+        loadInvalidateAttachments[loadInvalidateCount++] = glAttachment;
+      }
+      if (attachment.storeOp == AttachmentStoreOp::DONT_CARE)
+      {
+        sStoreInvalidateAttachments[sStoreInvalidateCount++] = glAttachment;
+      }
+    };
+
+    for (size_t i = 0; i < ri.colorAttachments.size(); i++)
+    {
+      addInvalidatedAttachment(ri.colorAttachments[i], static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i));
+    }
+    if (ri.depthAttachment)
+    {
+      addInvalidatedAttachment(*ri.depthAttachment, GL_DEPTH_ATTACHMENT);
+    }
+    if (ri.stencilAttachment)
+    {
+      addInvalidatedAttachment(*ri.stencilAttachment, GL_STENCIL_ATTACHMENT);
+    }
+
+    InvalidateFramebuffer(sFbo,
+                          {loadInvalidateAttachments.data(), loadInvalidateCount},
+                          sRenderArea,
+                          sRenderAreaCoversFramebuffer);
+
+    auto getResolveTexture = [](const RenderAttachment& attachment)
+    {
+      if (attachment.resolveTexture)
+      {
+        [[maybe_unused]] const auto& info = attachment.texture->CreateInfo();
+        [[maybe_unused]] const auto& resolveInfo = attachment.resolveTexture->CreateInfo();
+        FWOG_ASSERT(info.sampleCount != SampleCount::SAMPLES_1 && "Only multisampled attachments can be resolved");
+        FWOG_ASSERT(resolveInfo.sampleCount == SampleCount::SAMPLES_1);
+        FWOG_ASSERT(info.format == resolveInfo.format);
+        FWOG_ASSERT(GetAttachmentExtent(attachment).width == resolveInfo.extent.width &&
+                    GetAttachmentExtent(attachment).height == resolveInfo.extent.height);
+      }
+      return attachment.resolveTexture;
+    };
+
+    sColorResolveTextures = {};
+    for (size_t i = 0; i < ri.colorAttachments.size(); i++)
+    {
+      sColorResolveTextures[i] = getResolveTexture(ri.colorAttachments[i]);
+    }
+    sDepthResolveTexture = ri.depthAttachment ? getResolveTexture(*ri.depthAttachment) : nullptr;
+    sStencilResolveTexture = ri.stencilAttachment ? getResolveTexture(*ri.stencilAttachment) : nullptr;
+  }
+
+  // Blits the render area of each resolved attachment into its resolve texture, which resolves its samples.
+  // A blit reads a single color attachment, so there is one per resolved color attachment, and depth and stencil are
+  // resolved by the first.
+  static void ResolveAttachments()
+  {
+    const RenderAttachment depthResolve{.texture = sDepthResolveTexture};
+    const RenderAttachment stencilResolve{.texture = sStencilResolveTexture};
+    GLbitfield depthStencilMask = (sDepthResolveTexture ? GL_DEPTH_BUFFER_BIT : 0) |
+                                  (sStencilResolveTexture ? GL_STENCIL_BUFFER_BIT : 0);
+
+    auto blit = [&](const RenderAttachment* colorResolve, GLbitfield mask)
+    {
+      const RenderInfo resolveInfo{
+        .colorAttachments = {colorResolve, colorResolve ? 1u : 0u},
+        .depthAttachment = sDepthResolveTexture && (mask & GL_DEPTH_BUFFER_BIT) ? &depthResolve : nullptr,
+        .stencilAttachment = sStencilResolveTexture && (mask & GL_STENCIL_BUFFER_BIT) ? &stencilResolve : nullptr,
+      };
+      const auto x1 = sRenderArea.offset.x + static_cast<GLint>(sRenderArea.extent.width);
+      const auto y1 = sRenderArea.offset.y + static_cast<GLint>(sRenderArea.extent.height);
+      glBlitNamedFramebuffer(sFbo,
+                             sFboCache.CreateOrGetCachedFramebuffer(resolveInfo),
+                             sRenderArea.offset.x,
+                             sRenderArea.offset.y,
+                             x1,
+                             y1,
+                             sRenderArea.offset.x,
+                             sRenderArea.offset.y,
+                             x1,
+                             y1,
+                             mask,
+                             GL_NEAREST);
+    };
+
+    bool readBufferChanged = false;
+    for (size_t i = 0; i < sColorResolveTextures.size(); i++)
+    {
+      if (!sColorResolveTextures[i])
+      {
+        continue;
+      }
+
+      const RenderAttachment colorResolve{.texture = sColorResolveTextures[i]};
+      glNamedFramebufferReadBuffer(sFbo, static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i));
+      readBufferChanged |= i != 0;
+      blit(&colorResolve, GL_COLOR_BUFFER_BIT | depthStencilMask);
+      depthStencilMask = 0;
+    }
+
+    if (depthStencilMask != 0)
+    {
+      blit(nullptr, depthStencilMask);
+    }
+
+    if (readBufferChanged)
+    {
+      glNamedFramebufferReadBuffer(sFbo, GL_COLOR_ATTACHMENT0);
+    }
   }
 
   void EndRendering()
@@ -313,6 +478,24 @@ namespace Fwog
     isIndexBufferBound = false;
     isRenderingToSwapchain = false;
 
+    // blits are affected by the scissor test
+    if (sScissorEnabled)
+    {
+      glDisable(GL_SCISSOR_TEST);
+      sScissorEnabled = false;
+    }
+
+    ResolveAttachments();
+    sColorResolveTextures = {};
+    sDepthResolveTexture = nullptr;
+    sStencilResolveTexture = nullptr;
+
+    InvalidateFramebuffer(sFbo,
+                          {sStoreInvalidateAttachments.data(), sStoreInvalidateCount},
+                          sRenderArea,
+                          sRenderAreaCoversFramebuffer);
+    sStoreInvalidateCount = 0;
+
     if (isScopedDebugGroupPushed)
     {
       isScopedDebugGroupPushed = false;
@@ -324,12 +507,6 @@ namespace Fwog
       isPipelineDebugGroupPushed = false;
       glPopDebugGroup();
     }
-
-    if (sScissorEnabled)
-    {
-      glDisable(GL_SCISSOR_TEST);
-      sScissorEnabled = false;
-    }
   }
 
   void BeginCompute(std::string_view name)
@@ -442,6 +619,48 @@ namespace Fwog
                        extent.depth);
   }
 
+  // Write masks can be changed by clears, so they are compared with the tracked masks on every bind, even when the
+  // rest of the pipeline's state is already applied.
+  static void ApplyWriteMasks(const detail::GraphicsPipelineInfoOwning& pipelineState)
+  {
+    const auto& ds = pipelineState.depthState;
+    if (ds.depthTestEnable && ds.depthWriteEnable != sLastDepthMask)
+    {
+      glDepthMask(ds.depthWriteEnable);
+      sLastDepthMask = ds.depthWriteEnable;
+    }
+
+    const auto& ss = pipelineState.stencilState;
+    if (ss.stencilTestEnable)
+    {
+      if (sLastStencilMask[0] != ss.front.writeMask)
+      {
+        glStencilMaskSeparate(GL_FRONT, ss.front.writeMask);
+        sLastStencilMask[0] = ss.front.writeMask;
+      }
+      if (sLastStencilMask[1] != ss.back.writeMask)
+      {
+        glStencilMaskSeparate(GL_BACK, ss.back.writeMask);
+        sLastStencilMask[1] = ss.back.writeMask;
+      }
+    }
+
+    const auto& attachments = pipelineState.colorBlendState.attachments;
+    for (GLuint i = 0; i < static_cast<GLuint>(attachments.size()); i++)
+    {
+      const auto mask = attachments[i].colorWriteMask;
+      if (sLastColorMask[i] != mask)
+      {
+        glColorMaski(i,
+                     (mask & ColorComponentFlag::R_BIT) != ColorComponentFlag::NONE,
+                     (mask & ColorComponentFlag::G_BIT) != ColorComponentFlag::NONE,
+                     (mask & ColorComponentFlag::B_BIT) != ColorComponentFlag::NONE,
+                     (mask & ColorComponentFlag::A_BIT) != ColorComponentFlag::NONE);
+        sLastColorMask[i] = mask;
+      }
+    }
+  }
+
   namespace Cmd
   {
     void BindGraphicsPipeline(const GraphicsPipeline& pipeline)
@@ -449,10 +668,14 @@ namespace Fwog
       FWOG_ASSERT(isRendering);
       FWOG_ASSERT(pipeline.Handle() != 0);
 
-      auto pipelineState = detail::GetGraphicsPipelineInternal(pipeline.Handle());
+      const auto* pipelineState = detail::GetGraphicsPipelineInternal(pipeline.Handle());
       FWOG_ASSERT(pipelineState);
 
-      if (sLastGraphicsPipeline == pipelineState)
+      sBindingTracker.SetUsedSlots(*pipelineState->reflection);
+      ApplyWriteMasks(*pipelineState);
+
+      const auto& block = pipelineState->stateBlock;
+      if (block.serial == sLastStateBlock.serial)
       {
         return;
       }
@@ -473,108 +696,86 @@ namespace Fwog
       }
 
       //////////////////////////////////////////////////////////////// shader program
-      glUseProgram(static_cast<GLuint>(pipeline.Handle()));
+      glUseProgram(pipelineState->program);
+
+      // only state groups whose ids differ from the applied ones are touched
+      uint32_t dirtyGroups = 0;
+      for (uint32_t i = 0; i < block.groups.size(); i++)
+      {
+        dirtyGroups |= static_cast<uint32_t>(block.groups[i] != sLastStateBlock.groups[i]) << i;
+      }
+      auto isDirty = [dirtyGroups](detail::PipelineStateGroup group)
+      { return (dirtyGroups & (1u << static_cast<uint32_t>(group))) != 0; };
 
       //////////////////////////////////////////////////////////////// input assembly
       const auto& ias = pipelineState->inputAssemblyState;
-      if (!sLastGraphicsPipeline ||
-          ias.primitiveRestartEnable != sLastGraphicsPipeline->inputAssemblyState.primitiveRestartEnable)
+      if (isDirty(detail::PipelineStateGroup::INPUT_ASSEMBLY))
       {
         GLEnableOrDisable(GL_PRIMITIVE_RESTART_FIXED_INDEX, ias.primitiveRestartEnable);
       }
       sTopology = ias.topology;
 
       //////////////////////////////////////////////////////////////// vertex input
-      if (auto nextVao = sVaoCache.CreateOrGetCachedVertexArray(pipelineState->vertexInputState); nextVao != sVao)
+      if (isDirty(detail::PipelineStateGroup::VERTEX_INPUT))
       {
-        sVao = nextVao;
-        glBindVertexArray(sVao);
+        if (pipelineState->vertexArray != sVertexArray)
+        {
+          sVertexArray = pipelineState->vertexArray;
+          glBindVertexArray(sVertexArray->Handle());
+        }
       }
 
       //////////////////////////////////////////////////////////////// rasterization
       const auto& rs = pipelineState->rasterizationState;
-      if (!sLastGraphicsPipeline || rs.depthClampEnable != sLastGraphicsPipeline->rasterizationState.depthClampEnable)
+      if (isDirty(detail::PipelineStateGroup::RASTERIZATION))
       {
         GLEnableOrDisable(GL_DEPTH_CLAMP, rs.depthClampEnable);
-      }
-
-      if (!sLastGraphicsPipeline || rs.polygonMode != sLastGraphicsPipeline->rasterizationState.polygonMode)
-      {
         glPolygonMode(GL_FRONT_AND_BACK, detail::PolygonModeToGL(rs.polygonMode));
-      }
-
-      if (!sLastGraphicsPipeline || rs.cullMode != sLastGraphicsPipeline->rasterizationState.cullMode)
-      {
         GLEnableOrDisable(GL_CULL_FACE, rs.cullMode != CullMode::NONE);
         if (rs.cullMode != CullMode::NONE)
         {
           glCullFace(detail::CullModeToGL(rs.cullMode));
         }
-      }
-
-      if (!sLastGraphicsPipeline || rs.frontFace != sLastGraphicsPipeline->rasterizationState.frontFace)
-      {
         glFrontFace(detail::FrontFaceToGL(rs.frontFace));
+        glLineWidth(rs.lineWidth);
+        glPointSize(rs.pointSize);
+
+        const auto& ms = pipelineState->multisampleState;
+        GLEnableOrDisable(GL_SAMPLE_SHADING, ms.sampleShadingEnable);
+        if (ms.sampleShadingEnable)
+        {
+          glMinSampleShading(ms.minSampleShading);
+        }
+        GLEnableOrDisable(GL_SAMPLE_MASK, ms.sampleMask != 0xFFFFFFFF);
+        glSampleMaski(0, ms.sampleMask);
+        GLEnableOrDisable(GL_SAMPLE_ALPHA_TO_COVERAGE, ms.alphaToCoverageEnable);
+        GLEnableOrDisable(GL_SAMPLE_ALPHA_TO_ONE, ms.alphaToOneEnable);
       }
 
-      if (!sLastGraphicsPipeline || rs.depthBiasEnable != sLastGraphicsPipeline->rasterizationState.depthBiasEnable)
+      if (isDirty(detail::PipelineStateGroup::DEPTH_BIAS))
       {
         GLEnableOrDisable(GL_POLYGON_OFFSET_FILL, rs.depthBiasEnable);
         GLEnableOrDisable(GL_POLYGON_OFFSET_LINE, rs.depthBiasEnable);
         GLEnableOrDisable(GL_POLYGON_OFFSET_POINT, rs.depthBiasEnable);
-      }
-
-      if (!sLastGraphicsPipeline ||
-          rs.depthBiasSlopeFactor != sLastGraphicsPipeline->rasterizationState.depthBiasSlopeFactor ||
-          rs.depthBiasConstantFactor != sLastGraphicsPipeline->rasterizationState.depthBiasConstantFactor)
-      {
         glPolygonOffset(rs.depthBiasSlopeFactor, rs.depthBiasConstantFactor);
       }
 
-      if (!sLastGraphicsPipeline || rs.lineWidth != sLastGraphicsPipeline->rasterizationState.lineWidth)
-      {
-        glLineWidth(rs.lineWidth);
-      }
-
-      if (!sLastGraphicsPipeline || rs.pointSize != sLastGraphicsPipeline->rasterizationState.pointSize)
-      {
-        glPointSize(rs.pointSize);
-      }
-
       //////////////////////////////////////////////////////////////// depth + stencil
       const auto& ds = pipelineState->depthState;
-      if (!sLastGraphicsPipeline || ds.depthTestEnable != sLastGraphicsPipeline->depthState.depthTestEnable)
+      if (isDirty(detail::PipelineStateGroup::DEPTH))
       {
         GLEnableOrDisable(GL_DEPTH_TEST, ds.depthTestEnable);
-      }
-
-      if (ds.depthTestEnable)
-      {
-        if (!sLastGraphicsPipeline || ds.depthWriteEnable != sLastGraphicsPipeline->depthState.depthWriteEnable)
-        {
-          if (ds.depthWriteEnable != sLastDepthMask)
-          {
-            glDepthMask(ds.depthWriteEnable);
-            sLastDepthMask = ds.depthWriteEnable;
-          }
-        }
-
-        if (!sLastGraphicsPipeline || ds.depthCompareOp != sLastGraphicsPipeline->depthState.depthCompareOp)
+        if (ds.depthTestEnable)
         {
           glDepthFunc(detail::CompareOpToGL(ds.depthCompareOp));
         }
       }
 
       const auto& ss = pipelineState->stencilState;
-      if (!sLastGraphicsPipeline || ss.stencilTestEnable != sLastGraphicsPipeline->stencilState.stencilTestEnable)
+      if (isDirty(detail::PipelineStateGroup::STENCIL))
       {
         GLEnableOrDisable(GL_STENCIL_TEST, ss.stencilTestEnable);
-      }
-
-      if (ss.stencilTestEnable)
-      {
-        if (!sLastGraphicsPipeline || !sLastGraphicsPipeline->stencilState.stencilTestEnable ||
-            ss.front != sLastGraphicsPipeline->stencilState.front)
+        if (ss.stencilTestEnable)
         {
           glStencilOpSeparate(GL_FRONT,
                               detail::StencilOpToGL(ss.front.failOp),
@@ -584,16 +785,6 @@ namespace Fwog
                                 detail::CompareOpToGL(ss.front.compareOp),
                                 ss.front.reference,
                                 ss.front.compareMask);
-          if (sLastStencilMask[0] != ss.front.writeMask)
-          {
-            glStencilMaskSeparate(GL_FRONT, ss.front.writeMask);
-            sLastStencilMask[0] = ss.front.writeMask;
-          }
-        }
-
-        if (!sLastGraphicsPipeline || !sLastGraphicsPipeline->stencilState.stencilTestEnable ||
-            ss.back != sLastGraphicsPipeline->stencilState.back)
-        {
           glStencilOpSeparate(GL_BACK,
                               detail::StencilOpToGL(ss.back.failOp),
                               detail::StencilOpToGL(ss.back.depthFailOp),
@@ -602,31 +793,20 @@ namespace Fwog
                                 detail::CompareOpToGL(ss.back.compareOp),
                                 ss.back.reference,
                                 ss.back.compareMask);
-          if (sLastStencilMask[1] != ss.back.writeMask)
-          {
-            glStencilMaskSeparate(GL_BACK, ss.back.writeMask);
-            sLastStencilMask[1] = ss.back.writeMask;
-          }
         }
       }
 
       //////////////////////////////////////////////////////////////// color blending state
       const auto& cb = pipelineState->colorBlendState;
-      if (!sLastGraphicsPipeline || cb.logicOpEnable != sLastGraphicsPipeline->colorBlendState.logicOpEnable)
+      if (isDirty(detail::PipelineStateGroup::COLOR_BLEND))
       {
         GLEnableOrDisable(GL_COLOR_LOGIC_OP, cb.logicOpEnable);
-        if (!sLastGraphicsPipeline || !sLastGraphicsPipeline->colorBlendState.logicOpEnable ||
-            (cb.logicOpEnable && cb.logicOp != sLastGraphicsPipeline->colorBlendState.logicOp))
+        if (cb.logicOpEnable)
         {
           glLogicOp(detail::LogicOpToGL(cb.logicOp));
         }
-      }
-
-      if (!sLastGraphicsPipeline || std::memcmp(cb.blendConstants,
-                                                sLastGraphicsPipeline->colorBlendState.blendConstants,
-                                                sizeof(cb.blendConstants)) != 0)
-      {
         glBlendColor(cb.blendConstants[0], cb.blendConstants[1], cb.blendConstants[2], cb.blendConstants[3]);
+        GLEnableOrDisable(GL_BLEND, !cb.attachments.empty());
       }
 
       // FWOG_ASSERT((cb.attachments.empty()
@@ -634,49 +814,32 @@ namespace Fwog
       //   || sLastRenderInfo->colorAttachments.size() >= cb.attachments.size()
       //   && "There must be at least a color blend attachment for each render target, or none");
 
-      if (!sLastGraphicsPipeline ||
-          cb.attachments.empty() != sLastGraphicsPipeline->colorBlendState.attachments.empty())
-      {
-        GLEnableOrDisable(GL_BLEND, !cb.attachments.empty());
-      }
-
       for (GLuint i = 0; i < static_cast<GLuint>(cb.attachments.size()); i++)
       {
         const auto& cba = cb.attachments[i];
-        if (sLastGraphicsPipeline && i < sLastGraphicsPipeline->colorBlendState.attachments.size() &&
-            cba == sLastGraphicsPipeline->colorBlendState.attachments[i])
-        {
-          continue;
-        }
-
-        if (cba.blendEnable)
-        {
-          glBlendFuncSeparatei(i,
-                               detail::BlendFactorToGL(cba.srcColorBlendFactor),
-                               detail::BlendFactorToGL(cba.dstColorBlendFactor),
-                               detail::BlendFactorToGL(cba.srcAlphaBlendFactor),
-                               detail::BlendFactorToGL(cba.dstAlphaBlendFactor));
-          glBlendEquationSeparatei(i, detail::BlendOpToGL(cba.colorBlendOp), detail::BlendOpToGL(cba.alphaBlendOp));
-        }
-        else
-        {
-          // "no blending" blend state
-          glBlendFuncSeparatei(i, GL_SRC_COLOR, GL_ZERO, GL_SRC_ALPHA, GL_ZERO);
-          glBlendEquationSeparatei(i, GL_FUNC_ADD, GL_FUNC_ADD);
-        }
-
-        if (sLastColorMask[i] != cba.colorWriteMask)
+        if (block.colorBlendAttachments[i] != sLastStateBlock.colorBlendAttachments[i])
         {
-          glColorMaski(i,
-                       (cba.colorWriteMask & ColorComponentFlag::R_BIT) != ColorComponentFlag::NONE,
-                       (cba.colorWriteMask & ColorComponentFlag::G_BIT) != ColorComponentFlag::NONE,
-                       (cba.colorWriteMask & ColorComponentFlag::B_BIT) != ColorComponentFlag::NONE,
-                       (cba.colorWriteMask & ColorComponentFlag::A_BIT) != ColorComponentFlag::NONE);
-          sLastColorMask[i] = cba.colorWriteMask;
+          if (cba.blendEnable)
+          {
+            glBlendFuncSeparatei(i,
+                                 detail::BlendFactorToGL(cba.srcColorBlendFactor),
+                                 detail::BlendFactorToGL(cba.dstColorBlendFactor),
+                                 detail::BlendFactorToGL(cba.srcAlphaBlendFactor),
+                                 detail::BlendFactorToGL(cba.dstAlphaBlendFactor));
+            glBlendEquationSeparatei(i, detail::BlendOpToGL(cba.colorBlendOp), detail::BlendOpToGL(cba.alphaBlendOp));
+          }
+          else
+          {
+            // "no blending" blend state
+            glBlendFuncSeparatei(i, GL_SRC_COLOR, GL_ZERO, GL_SRC_ALPHA, GL_ZERO);
+            glBlendEquationSeparatei(i, GL_FUNC_ADD, GL_FUNC_ADD);
+          }
+          sLastStateBlock.colorBlendAttachments[i] = block.colorBlendAttachments[i];
         }
       }
 
-      sLastGraphicsPipeline = pipelineState;
+      sLastStateBlock.serial = block.serial;
+      sLastStateBlock.groups = block.groups;
     }
 
     void BindComputePipeline(const ComputePipeline& pipeline)
@@ -684,7 +847,10 @@ namespace Fwog
       FWOG_ASSERT(isComputeActive);
       FWOG_ASSERT(pipeline.Handle() != 0);
 
-      auto pipelineState = detail::GetComputePipelineInternal(pipeline.Handle());
+      const auto* pipelineState = detail::GetComputePipelineInternal(pipeline.Handle());
+      FWOG_ASSERT(pipelineState);
+
+      sBindingTracker.SetUsedSlots(*pipelineState->reflection);
 
       if (isPipelineDebugGroupPushed)
       {
@@ -701,14 +867,14 @@ namespace Fwog
         isPipelineDebugGroupPushed = true;
       }
 
-      glUseProgram(static_cast<GLuint>(pipeline.Handle()));
+      glUseProgram(pipelineState->program);
     }
 
     void SetViewport(const Viewport& viewport)
     {
       FWOG_ASSERT(isRendering);
 
-      if (viewport == sLastViewport)
+      if (!sInitViewport && viewport == sLastViewport)
       {
         return;
       }
@@ -720,6 +886,32 @@ namespace Fwog
       glDepthRangef(viewport.minDepth, viewport.maxDepth);
 
       sLastViewport = viewport;
+      sInitViewport = false;
+    }
+
+    void SetViewports(std::span<const Viewport> viewports, uint32_t firstViewport)
+    {
+      FWOG_ASSERT(isRendering);
+      FWOG_ASSERT(viewports.size() <= MAX_VIEWPORTS);
+
+      std::array<GLfloat, 4 * MAX_VIEWPORTS> rects;
+      std::array<GLdouble, 2 * MAX_VIEWPORTS> depthRanges;
+      for (size_t i = 0; i < viewports.size(); i++)
+      {
+        const auto& drawRect = viewports[i].drawRect;
+        rects[4 * i + 0] = static_cast<GLfloat>(drawRect.offset.x);
+        rects[4 * i + 1] = static_cast<GLfloat>(drawRect.offset.y);
+        rects[4 * i + 2] = static_cast<GLfloat>(drawRect.extent.width);
+        rects[4 * i + 3] = static_cast<GLfloat>(drawRect.extent.height);
+        depthRanges[2 * i + 0] = viewports[i].minDepth;
+        depthRanges[2 * i + 1] = viewports[i].maxDepth;
+      }
+
+      glViewportArrayv(firstViewport, static_cast<GLsizei>(viewports.size()), rects.data());
+      glDepthRangeArrayv(firstViewport, static_cast<GLsizei>(viewports.size()), depthRanges.data());
+
+      // the viewports no longer share a state, so the next SetViewport or BeginRendering must set it
+      sInitViewport = true;
     }
 
     void SetScissor(const Rect2D& scissor)
@@ -732,7 +924,7 @@ namespace Fwog
         sScissorEnabled = true;
       }
 
-      if (scissor == sLastScissor)
+      if (!sInitScissor && scissor == sLastScissor)
       {
         return;
       }
@@ -740,32 +932,60 @@ namespace Fwog
       glScissor(scissor.offset.x, scissor.offset.y, scissor.extent.width, scissor.extent.height);
 
       sLastScissor = scissor;
+      sInitScissor = false;
+    }
+
+    void SetScissors(std::span<const Rect2D> scissors, uint32_t firstScissor)
+    {
+      FWOG_ASSERT(isRendering);
+      FWOG_ASSERT(scissors.size() <= MAX_VIEWPORTS);
+
+      if (!sScissorEnabled)
+      {
+        glEnable(GL_SCISSOR_TEST);
+        sScissorEnabled = true;
+      }
+
+      std::array<GLint, 4 * MAX_VIEWPORTS> rects;
+      for (size_t i = 0; i < scissors.size(); i++)
+      {
+        rects[4 * i + 0] = static_cast<GLint>(scissors[i].offset.x);
+        rects[4 * i + 1] = static_cast<GLint>(scissors[i].offset.y);
+        rects[4 * i + 2] = static_cast<GLint>(scissors[i].extent.width);
+        rects[4 * i + 3] = static_cast<GLint>(scissors[i].extent.height);
+      }
+
+      glScissorArrayv(firstScissor, static_cast<GLsizei>(scissors.size()), rects.data());
+      sInitScissor = true;
     }
 
     void BindVertexBuffer(uint32_t bindingIndex, const Buffer& buffer, uint64_t offset, uint64_t stride)
     {
       FWOG_ASSERT(isRendering);
+      FWOG_ASSERT(sVertexArray && "A pipeline must be bound before vertex buffers");
 
-      glVertexArrayVertexBuffer(sVao,
-                                bindingIndex,
-                                buffer.Handle(),
-                                static_cast<GLintptr>(offset),
-                                static_cast<GLsizei>(stride));
+      sVertexArray->BindVertexBuffer(bindingIndex,
+                                     buffer.Handle(),
+                                     static_cast<GLintptr>(offset),
+                                     static_cast<GLsizei>(stride));
     }
 
     void BindIndexBuffer(const Buffer& buffer, IndexType indexType)
     {
       FWOG_ASSERT(isRendering);
+      FWOG_ASSERT(sVertexArray && "A pipeline must be bound before an index buffer");
 
       isIndexBufferBound = true;
       sIndexType = indexType;
-      glVertexArrayElementBuffer(sVao, buffer.Handle());
+      sVertexArray->BindIndexBuffer(buffer.Handle());
     }
 
     void Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t firstVertex, uint32_t firstInstance)
     {
       FWOG_ASSERT(isRendering);
 
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glDrawArraysInstancedBaseInstance(detail::PrimitiveTopologyToGL(sTopology),
                                         firstVertex,
                                         vertexCount,
@@ -779,6 +999,8 @@ namespace Fwog
       FWOG_ASSERT(isRendering);
       FWOG_ASSERT(isIndexBufferBound);
 
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glDrawElementsInstancedBaseVertexBaseInstance(
           detail::PrimitiveTopologyToGL(sTopology),
           indexCount,
@@ -796,6 +1018,8 @@ namespace Fwog
       FWOG_ASSERT(isRendering);
 
       glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.Handle());
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glMultiDrawArraysIndirect(detail::PrimitiveTopologyToGL(sTopology),
                                 reinterpret_cast<void*>(static_cast<uintptr_t>(commandBufferOffset)),
                                 drawCount,
@@ -813,6 +1037,8 @@ namespace Fwog
 
       glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.Handle());
       glBindBuffer(GL_PARAMETER_BUFFER, countBuffer.Handle());
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glMultiDrawArraysIndirectCount(detail::PrimitiveTopologyToGL(sTopology),
                                      reinterpret_cast<void*>(static_cast<uintptr_t>(commandBufferOffset)),
                                      static_cast<GLintptr>(countBufferOffset),
@@ -827,6 +1053,8 @@ namespace Fwog
       FWOG_ASSERT(isIndexBufferBound);
 
       glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.Handle());
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glMultiDrawElementsIndirect(detail::PrimitiveTopologyToGL(sTopology),
                                   detail::IndexTypeToGL(sIndexType),
                                   reinterpret_cast<void*>(static_cast<uintptr_t>(commandBufferOffset)),
@@ -846,6 +1074,8 @@ namespace Fwog
 
       glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer.Handle());
       glBindBuffer(GL_PARAMETER_BUFFER, countBuffer.Handle());
+      sBindingTracker.Flush();
+      sVertexArray->Flush();
       glMultiDrawElementsIndirectCount(detail::PrimitiveTopologyToGL(sTopology),
                                        detail::IndexTypeToGL(sIndexType),
                                        reinterpret_cast<void*>(static_cast<uintptr_t>(commandBufferOffset)),
@@ -857,23 +1087,44 @@ namespace Fwog
     void BindUniformBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size)
     {
       FWOG_ASSERT(isRendering || isComputeActive);
+      FWOG_ASSERT(offset <= buffer.Size());
 
-      glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer.Handle(), offset, size);
+      // the range is clamped to the size of the block the pipeline declares when it is flushed
+      const bool wholeBuffer = size == WHOLE_BUFFER;
+      if (wholeBuffer)
+      {
+        size = buffer.Size() - offset;
+      }
+
+      sBindingTracker.BindUniformBuffer(index,
+                                        buffer.Handle(),
+                                        static_cast<GLintptr>(offset),
+                                        static_cast<GLsizeiptr>(size),
+                                        wholeBuffer);
     }
 
     void BindStorageBuffer(uint32_t index, const Buffer& buffer, uint64_t offset, uint64_t size)
     {
       FWOG_ASSERT(isRendering || isComputeActive);
+      FWOG_ASSERT(offset <= buffer.Size());
+
+      // storage blocks can end in a runtime-sized array, so the rest of the buffer is bound
+      if (size == WHOLE_BUFFER)
+      {
+        size = buffer.Size() - offset;
+      }
 
-      glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, buffer.Handle(), offset, size);
+      sBindingTracker.BindStorageBuffer(index,
+                                        buffer.Handle(),
+                                        static_cast<GLintptr>(offset),
+                                        static_cast<GLsizeiptr>(size));
     }
 
     void BindSampledImage(uint32_t index, const Texture& texture, const Sampler& sampler)
     {
       FWOG_ASSERT(isRendering || isComputeActive);
 
-      glBindTextureUnit(index, texture.Handle());
-      glBindSampler(index, sampler.Handle());
+      sBindingTracker.BindSampledImage(index, texture.Handle(), sampler.Handle());
     }
 
     void BindImage(uint32_t index, const Texture& texture, uint32_t level)
@@ -881,19 +1132,24 @@ namespace Fwog
       FWOG_ASSERT(isRendering || isComputeActive);
       FWOG_ASSERT(level < texture.CreateInfo().mipLevels);
 
-      glBindImageTexture(index,
-                         texture.Handle(),
-                         level,
-                         GL_TRUE,
-                         0,
-                         GL_READ_WRITE,
-                         detail::FormatToGL(texture.CreateInfo().format));
+      sBindingTracker.BindImage(index,
+                                texture.Handle(),
+                                static_cast<GLint>(level),
+                                detail::FormatToGL(texture.CreateInfo().format));
+    }
+
+    void BindGroup(const Fwog::BindGroup& group)
+    {
+      FWOG_ASSERT(isRendering || isComputeActive);
+
+      sBindingTracker.BindGroup(group);
     }
 
     void Dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ)
     {
       FWOG_ASSERT(isComputeActive);
 
+      sBindingTracker.Flush();
       glDispatchCompute(groupCountX, groupCountY, groupCountZ);
     }
 
@@ -902,6 +1158,7 @@ namespace Fwog
       FWOG_ASSERT(isComputeActive);
 
       glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, commandBuffer.Handle());
+      sBindingTracker.Flush();
       glDispatchComputeIndirect(static_cast<GLintptr>(commandBufferOffset));
     }
 
@@ -1,9 +1,13 @@
 #include <Fwog/Common.h>
 #include <Fwog/Exception.h>
+#include <Fwog/PipelineCache.h>
 #include <Fwog/Shader.h>
+#include <Fwog/detail/Hash.h>
+#include <bit>
 #include <string>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 namespace Fwog
 {
@@ -19,31 +23,125 @@ namespace Fwog
       default: FWOG_UNREACHABLE; return 0;
       }
     }
+
+    // deletes the shader and throws if it failed to compile
+    void CheckCompileStatus(GLuint id)
+    {
+      GLint success;
+      glGetShaderiv(id, GL_COMPILE_STATUS, &success);
+      if (!success)
+      {
+        std::string infoLog;
+        const GLsizei infoLength = 512;
+        infoLog.resize(infoLength + 1, '\0');
+        glGetShaderInfoLog(id, infoLength, nullptr, infoLog.data());
+        glDeleteShader(id);
+        throw ShaderCompilationException("Failed to compile shader source.\n" + infoLog);
+      }
+    }
+
+    GLuint CompileShader(PipelineStage stage, std::string_view source)
+    {
+      const GLchar* strings = source.data();
+      const auto length = static_cast<GLint>(source.size());
+
+      GLuint id = glCreateShader(PipelineStageToGL(stage));
+      glShaderSource(id, 1, &strings, &length);
+      glCompileShader(id);
+      CheckCompileStatus(id);
+      return id;
+    }
+
+    GLuint SpecializeShader(PipelineStage stage,
+                            std::span<const uint32_t> spirv,
+                            const std::string& entryPoint,
+                            std::span<const GLuint> constantIndices,
+                            std::span<const GLuint> constantValues)
+    {
+      GLuint id = glCreateShader(PipelineStageToGL(stage));
+      glShaderBinary(1, &id, GL_SHADER_BINARY_FORMAT_SPIR_V, spirv.data(), static_cast<GLsizei>(spirv.size_bytes()));
+      glSpecializeShader(id,
+                         entryPoint.c_str(),
+                         static_cast<GLuint>(constantIndices.size()),
+                         constantIndices.data(),
+                         constantValues.data());
+      CheckCompileStatus(id);
+      return id;
+    }
+
+    uint32_t SpecializationConstantBits(const SpecializationConstant& constant)
+    {
+      return std::visit(
+        [](auto value)
+        {
+          if constexpr (std::is_same_v<decltype(value), bool>)
+          {
+            return static_cast<uint32_t>(value);
+          }
+          else
+          {
+            return std::bit_cast<uint32_t>(value);
+          }
+        },
+        constant.value);
+    }
   } // namespace
 
   Shader::Shader(PipelineStage stage, std::string_view source)
+      : sourceHash_(HashSource(stage, source)),
+        sourceSize_(source.size())
   {
-    const GLchar* strings = source.data();
+    if (GetPipelineCache())
+    {
+      deferredCompile_ = [stage, source = std::string(source)] { return CompileShader(stage, source); };
+      return;
+    }
 
-    GLuint id = glCreateShader(PipelineStageToGL(stage));
-    glShaderSource(id, 1, &strings, nullptr);
-    glCompileShader(id);
+    id_ = CompileShader(stage, source);
+  }
+
+  Shader::Shader(PipelineStage stage,
+                 std::span<const uint32_t> spirv,
+                 std::string_view entryPoint,
+                 std::span<const SpecializationConstant> specializationConstants)
+  {
+    std::vector<GLuint> constantIndices;
+    std::vector<GLuint> constantValues;
+    for (const auto& constant : specializationConstants)
+    {
+      constantIndices.push_back(constant.index);
+      constantValues.push_back(SpecializationConstantBits(constant));
+    }
+
+    // constants are part of the hash, since each specialization links to a different program
+    sourceHash_ = detail::hashing::fnv1a(spirv.data(), spirv.size_bytes(), static_cast<uint64_t>(stage) + 1);
+    sourceHash_ = detail::hashing::fnv1a(entryPoint.data(), entryPoint.size(), sourceHash_);
+    sourceHash_ = detail::hashing::fnv1a(constantIndices.data(), constantIndices.size() * sizeof(GLuint), sourceHash_);
+    sourceHash_ = detail::hashing::fnv1a(constantValues.data(), constantValues.size() * sizeof(GLuint), sourceHash_);
+    sourceSize_ =
+      spirv.size_bytes() + entryPoint.size() + (constantIndices.size() + constantValues.size()) * sizeof(GLuint);
 
-    GLint success;
-    glGetShaderiv(id, GL_COMPILE_STATUS, &success);
-    if (!success)
+    if (GetPipelineCache())
     {
-      std::string infoLog;
-      const GLsizei infoLength = 512;
-      infoLog.resize(infoLength + 1, '\0');
-      glGetShaderInfoLog(id, infoLength, nullptr, infoLog.data());
-      throw ShaderCompilationException("Failed to compile shader source.\n" + infoLog);
+      deferredCompile_ = [stage,
+                          spirv = std::vector<uint32_t>(spirv.begin(), spirv.end()),
+                          entryPoint = std::string(entryPoint),
+                          constantIndices = std::move(constantIndices),
+                          constantValues = std::move(constantValues)]
+      { return SpecializeShader(stage, spirv, entryPoint, constantIndices, constantValues); };
+      return;
     }
 
-    id_ = id;
+    id_ = SpecializeShader(stage, spirv, std::string(entryPoint), constantIndices, constantValues);
   }
 
-  Shader::Shader(Shader&& old) noexcept : id_(std::exchange(old.id_, 0)) {}
+  Shader::Shader(Shader&& old) noexcept
+      : id_(std::exchange(old.id_, 0)),
+        sourceHash_(old.sourceHash_),
+        sourceSize_(old.sourceSize_),
+        deferredCompile_(std::move(old.deferredCompile_))
+  {
+  }
 
   Shader& Shader::operator=(Shader&& old) noexcept
   {
@@ -53,6 +151,21 @@ namespace Fwog
     return *new (this) Shader(std::move(old));
   }
 
+  uint64_t Shader::HashSource(PipelineStage stage, std::string_view source)
+  {
+    return detail::hashing::fnv1a(source.data(), source.size(), static_cast<uint64_t>(stage) + 1);
+  }
+
+  uint32_t Shader::Handle() const
+  {
+    if (id_ == 0 && deferredCompile_)
+    {
+      id_ = deferredCompile_();
+      deferredCompile_ = nullptr;
+    }
+    return id_;
+  }
+
   Shader::~Shader()
   {
     glDeleteShader(id_);
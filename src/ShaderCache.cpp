@@ -0,0 +1,34 @@
+#include <Fwog/ShaderCache.h>
+
+namespace Fwog
+{
+  std::shared_ptr<const Shader> ShaderCache::GetOrCompile(PipelineStage stage, std::string_view source)
+  {
+    // the hash only narrows the search, since different sources can collide
+    const uint64_t hash = Shader::HashSource(stage, source);
+    auto [first, last] = shaders_.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+      if (it->second.stage == stage && it->second.source == source)
+      {
+        hits_++;
+        return it->second.shader;
+      }
+    }
+
+    misses_++;
+    auto shader = std::make_shared<const Shader>(stage, source);
+    shaders_.emplace(hash, Entry{stage, std::string(source), shader});
+    return shader;
+  }
+
+  size_t ShaderCache::Trim()
+  {
+    return std::erase_if(shaders_, [](const auto& pair) { return pair.second.shader.use_count() == 1; });
+  }
+
+  void ShaderCache::Clear()
+  {
+    shaders_.clear();
+  }
+} // namespace Fwog
@@ -0,0 +1,288 @@
+#include <Fwog/Exception.h>
+#include <Fwog/ShaderSourceLoader.h>
+#include <Fwog/detail/Hash.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace Fwog
+{
+  namespace
+  {
+    std::string NormalizePath(const std::filesystem::path& path)
+    {
+      return path.lexically_normal().generic_string();
+    }
+
+    size_t FindLineEnd(std::string_view text, size_t pos)
+    {
+      const size_t end = text.find_first_of("\r\n", pos);
+      return end == std::string_view::npos ? text.size() : end;
+    }
+
+    size_t SkipNewline(std::string_view text, size_t lineEnd)
+    {
+      if (text.compare(lineEnd, 2, "\r\n") == 0)
+      {
+        return lineEnd + 2;
+      }
+      return std::min(lineEnd + 1, text.size());
+    }
+
+    std::string_view TrimLeft(std::string_view line)
+    {
+      const size_t first = line.find_first_not_of(" \t");
+      return first == std::string_view::npos ? std::string_view{} : line.substr(first);
+    }
+
+    // returns the quoted path if line is an #include "path" directive
+    std::optional<std::string_view> ParseInclude(std::string_view line)
+    {
+      line = TrimLeft(line);
+      if (!line.starts_with('#'))
+      {
+        return std::nullopt;
+      }
+
+      line = TrimLeft(line.substr(1));
+      if (!line.starts_with("include") || line.size() == 7 || (line[7] != ' ' && line[7] != '\t'))
+      {
+        return std::nullopt;
+      }
+
+      line = TrimLeft(line.substr(7));
+      if (!line.starts_with('"'))
+      {
+        return std::nullopt;
+      }
+
+      const size_t closingQuote = line.find('"', 1);
+      if (closingQuote == std::string_view::npos)
+      {
+        return std::nullopt;
+      }
+
+      return line.substr(1, closingQuote - 1);
+    }
+  } // namespace
+
+  ShaderSourceLoader::ShaderSourceLoader(std::vector<std::string> includeDirectories)
+      : includeDirectories_(std::move(includeDirectories))
+  {
+  }
+
+  uint32_t ShaderSourceLoader::GetFileIndex(std::string_view path)
+  {
+    auto normalizedPath = NormalizePath(path);
+    if (auto it = fileIndices_.find(normalizedPath); it != fileIndices_.end())
+    {
+      return it->second;
+    }
+
+    const auto index = static_cast<uint32_t>(files_.size());
+    files_.emplace_back().path = normalizedPath;
+    fileIndices_.emplace(std::move(normalizedPath), index);
+    return index;
+  }
+
+  ShaderSourceLoader::File& ShaderSourceLoader::GetLoadedFile(uint32_t index)
+  {
+    // files_ is a deque, so this reference survives files being added below
+    auto& file = files_[index];
+    if (file.loaded)
+    {
+      return file;
+    }
+
+    std::ifstream stream(file.path, std::ios::binary);
+    if (!stream)
+    {
+      throw ShaderCompilationException("Failed to open shader source file " + file.path);
+    }
+    file.text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    fileReads_++;
+
+    const auto directory = std::filesystem::path(file.path).parent_path();
+    const std::string_view text = file.text;
+    uint32_t lineNumber = 1;
+    for (size_t pos = 0; pos < text.size(); lineNumber++)
+    {
+      const size_t lineEnd = FindLineEnd(text, pos);
+      if (auto includePath = ParseInclude(text.substr(pos, lineEnd - pos)))
+      {
+        // fall back to the including file's directory so a missing file is reported with a sensible path
+        auto resolvedPath = directory / *includePath;
+        if (!std::filesystem::exists(resolvedPath))
+        {
+          for (const auto& includeDirectory : includeDirectories_)
+          {
+            if (auto candidate = std::filesystem::path(includeDirectory) / *includePath;
+                std::filesystem::exists(candidate))
+            {
+              resolvedPath = std::move(candidate);
+              break;
+            }
+          }
+        }
+
+        const uint32_t includedIndex = GetFileIndex(resolvedPath.string());
+        file.includes.push_back({
+          .begin = pos,
+          .end = lineEnd,
+          .nextLine = lineNumber + 1,
+          .file = includedIndex,
+        });
+
+        auto& includedBy = files_[includedIndex].includedBy;
+        if (std::find(includedBy.begin(), includedBy.end(), index) == includedBy.end())
+        {
+          includedBy.push_back(index);
+        }
+      }
+      pos = SkipNewline(text, lineEnd);
+    }
+
+    file.loaded = true;
+    return file;
+  }
+
+  const std::string& ShaderSourceLoader::Expand(uint32_t index, std::vector<uint32_t>& includeStack)
+  {
+    auto& file = GetLoadedFile(index);
+    if (file.expanded)
+    {
+      return *file.expanded;
+    }
+
+    if (std::find(includeStack.begin(), includeStack.end(), index) != includeStack.end())
+    {
+      throw ShaderCompilationException("Shader source file " + file.path + " includes itself");
+    }
+    includeStack.push_back(index);
+
+    std::string expanded;
+    size_t last = 0;
+    for (const auto& include : file.includes)
+    {
+      expanded.append(file.text, last, include.begin - last);
+      expanded += "#line 1 " + std::to_string(include.file) + "\n";
+      expanded += Expand(include.file, includeStack);
+      // the directive's newline follows, so no newline is needed after the #line directive
+      expanded += "\n#line " + std::to_string(include.nextLine) + " " + std::to_string(index);
+      last = include.end;
+    }
+    expanded.append(file.text, last);
+
+    includeStack.pop_back();
+    file.expanded = std::move(expanded);
+    return *file.expanded;
+  }
+
+  ShaderSource ShaderSourceLoader::Load(std::string_view path, std::span<const ShaderDefine> defines)
+  {
+    const uint32_t index = GetFileIndex(path);
+    std::vector<uint32_t> includeStack;
+    std::string source = Expand(index, includeStack);
+
+    // defines go after #version, which must come first
+    size_t insertPos = 0;
+    uint32_t nextLine = 1;
+    for (size_t pos = 0, lineNumber = 1; pos < source.size(); lineNumber++)
+    {
+      const size_t lineEnd = FindLineEnd(source, pos);
+      if (TrimLeft(std::string_view(source).substr(pos, lineEnd - pos)).starts_with("#version"))
+      {
+        insertPos = SkipNewline(source, lineEnd);
+        nextLine = static_cast<uint32_t>(lineNumber + 1);
+        break;
+      }
+      pos = SkipNewline(source, lineEnd);
+    }
+
+    std::string prologue = insertPos > 0 && source[insertPos - 1] != '\n' ? "\n" : "";
+    for (const auto& define : defines)
+    {
+      prologue.append("#define ").append(define.name).append(" ").append(define.value).append("\n");
+    }
+    prologue += "#line " + std::to_string(nextLine) + " " + std::to_string(index) + "\n";
+    source.insert(insertPos, prologue);
+
+    const uint64_t hash = detail::hashing::fnv1a(source.data(), source.size());
+    return {.source = std::move(source), .hash = hash};
+  }
+
+  std::vector<std::string> ShaderSourceLoader::GetDependencies(std::string_view path)
+  {
+    const uint32_t root = GetFileIndex(path);
+    std::vector<std::string> dependencies;
+    std::vector<bool> visited;
+    std::vector<uint32_t> stack{root};
+    while (!stack.empty())
+    {
+      const uint32_t index = stack.back();
+      stack.pop_back();
+
+      visited.resize(files_.size());
+      if (visited[index])
+      {
+        continue;
+      }
+      visited[index] = true;
+
+      const auto& file = GetLoadedFile(index);
+      if (index != root)
+      {
+        dependencies.push_back(file.path);
+      }
+
+      // push in reverse so includes are visited in order
+      for (auto it = file.includes.rbegin(); it != file.includes.rend(); ++it)
+      {
+        stack.push_back(it->file);
+      }
+    }
+    return dependencies;
+  }
+
+  void ShaderSourceLoader::Invalidate(std::string_view path)
+  {
+    auto it = fileIndices_.find(NormalizePath(path));
+    if (it == fileIndices_.end())
+    {
+      return;
+    }
+
+    auto& file = files_[it->second];
+    file.loaded = false;
+    file.text = {};
+    file.includes.clear();
+
+    std::vector<bool> visited(files_.size());
+    std::vector<uint32_t> stack{it->second};
+    while (!stack.empty())
+    {
+      const uint32_t index = stack.back();
+      stack.pop_back();
+      if (visited[index])
+      {
+        continue;
+      }
+      visited[index] = true;
+
+      auto& dependent = files_[index];
+      dependent.expanded.reset();
+      stack.insert(stack.end(), dependent.includedBy.begin(), dependent.includedBy.end());
+    }
+  }
+
+  std::string_view ShaderSourceLoader::GetSourceStringPath(uint32_t sourceStringNumber) const
+  {
+    if (sourceStringNumber >= files_.size())
+    {
+      return {};
+    }
+    return files_[sourceStringNumber].path;
+  }
+} // namespace Fwog
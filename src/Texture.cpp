@@ -1,8 +1,11 @@
+#include <Fwog/BindlessResidencyManager.h>
 #include <Fwog/Common.h>
 #include <Fwog/Texture.h>
 #include <Fwog/detail/ApiToEnum.h>
 #include <Fwog/detail/SamplerCache.h>
 #include <Fwog/detail/FramebufferCache.h>
+#include <Fwog/detail/BindingStateTracker.h>
+#include <algorithm>
 #include <array>
 #include <utility>
 
@@ -18,6 +21,7 @@ namespace Fwog
   }
 
   extern detail::FramebufferCache sFboCache;
+  extern detail::BindingStateTracker sBindingTracker;
 
   namespace // detail
   {
@@ -158,7 +162,7 @@ namespace Fwog
 
   Texture::Texture(Texture&& old) noexcept
       : id_(std::exchange(old.id_, 0)), createInfo_(old.createInfo_),
-        bindlessHandle_(std::exchange(old.bindlessHandle_, 0))
+        bindlessHandles_(std::move(old.bindlessHandles_))
   {
   }
 
@@ -172,13 +176,15 @@ namespace Fwog
 
   Texture::~Texture()
   {
-    if (bindlessHandle_ != 0)
+    for (auto handle : bindlessHandles_)
     {
-      glMakeTextureHandleNonResidentARB(bindlessHandle_);
+      glMakeTextureHandleNonResidentARB(handle);
     }
+    detail::RemoveTextureFromResidencyManagers(id_);
     glDeleteTextures(1, &id_);
     // Ensure that the texture is no longer referenced in the FBO cache
     sFboCache.RemoveTexture(*this);
+    sBindingTracker.RemoveTexture(id_);
   }
 
   TextureView Texture::CreateMipView(uint32_t level) const
@@ -209,11 +215,15 @@ namespace Fwog
 
   uint64_t Texture::GetBindlessHandle(Sampler sampler)
   {
-    FWOG_ASSERT(bindlessHandle_ == 0 && "Texture already has bindless handle resident.");
-    bindlessHandle_ = glGetTextureHandleARB(id_);
-    FWOG_ASSERT(bindlessHandle_ != 0 && "Failed to create texture sampler handle.");
-    glMakeTextureHandleResidentARB(bindlessHandle_);
-    return bindlessHandle_;
+    // the same texture and sampler always produce the same handle, which can only be made resident once
+    const uint64_t handle = glGetTextureSamplerHandleARB(id_, sampler.Handle());
+    FWOG_ASSERT(handle != 0 && "Failed to create texture sampler handle.");
+    if (std::find(bindlessHandles_.begin(), bindlessHandles_.end(), handle) == bindlessHandles_.end())
+    {
+      glMakeTextureHandleResidentARB(handle);
+      bindlessHandles_.push_back(handle);
+    }
+    return handle;
   }
 
   void Texture::SubImage(const TextureUpdateInfo& info)
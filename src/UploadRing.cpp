@@ -0,0 +1,78 @@
+#include <Fwog/Common.h>
+#include <Fwog/UploadRing.h>
+#include <algorithm>
+
+namespace Fwog
+{
+  namespace
+  {
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+      return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // allocations may be bound as uniform or storage buffers
+    uint64_t GetBindingAlignment()
+    {
+      GLint uniformAlignment{};
+      GLint storageAlignment{};
+      glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+      glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+      return static_cast<uint64_t>(std::max({uniformAlignment, storageAlignment, 1}));
+    }
+  } // namespace
+
+  UploadRing::UploadRing(uint64_t frameSize, uint32_t framesInFlight)
+      : alignment_(GetBindingAlignment()),
+        frameSize_(AlignUp(frameSize, alignment_)),
+        buffer_(frameSize_ * framesInFlight,
+                BufferStorageFlag::NONE,
+                BufferMapFlag::MAP_WRITE | BufferMapFlag::MAP_PERSISTENT | BufferMapFlag::MAP_COHERENT),
+        mapping_(static_cast<std::byte*>(
+          buffer_.Map(BufferMapFlag::MAP_WRITE | BufferMapFlag::MAP_PERSISTENT | BufferMapFlag::MAP_COHERENT))),
+        regions_(framesInFlight)
+  {
+    FWOG_ASSERT(frameSize > 0 && framesInFlight > 0);
+    FWOG_ASSERT(mapping_);
+  }
+
+  UploadRing::~UploadRing()
+  {
+    buffer_.Unmap();
+  }
+
+  void UploadRing::BeginFrame()
+  {
+    FWOG_ASSERT(!inFrame_ && "EndFrame must be called before the next BeginFrame");
+    inFrame_ = true;
+
+    auto& region = regions_[frame_];
+    if (region.pending)
+    {
+      region.fence.WaitUntilSignaled();
+      region.pending = false;
+    }
+    head_ = frame_ * frameSize_;
+  }
+
+  void UploadRing::EndFrame()
+  {
+    FWOG_ASSERT(inFrame_ && "BeginFrame must be called before EndFrame");
+    inFrame_ = false;
+
+    auto& region = regions_[frame_];
+    region.fence.Signal();
+    region.pending = true;
+    frame_ = (frame_ + 1) % static_cast<uint32_t>(regions_.size());
+  }
+
+  void* UploadRing::AllocateBytes(uint64_t size, uint64_t alignment, uint64_t& offset)
+  {
+    FWOG_ASSERT(inFrame_ && "Allocations can only be made between BeginFrame and EndFrame");
+
+    offset = AlignUp(head_, std::max(alignment, alignment_));
+    FWOG_ASSERT(offset + size <= (frame_ + 1) * frameSize_ && "The frame's region of the upload ring is full");
+    head_ = offset + size;
+    return mapping_ + offset;
+  }
+} // namespace Fwog
@@ -38,6 +38,10 @@ namespace Fwog::detail
     ret |= flags & BufferMapFlag::MAP_WRITE ? GL_MAP_WRITE_BIT : 0;
     ret |= flags & BufferMapFlag::MAP_PERSISTENT ? GL_MAP_PERSISTENT_BIT : 0;
     ret |= flags & BufferMapFlag::MAP_COHERENT ? GL_MAP_COHERENT_BIT : 0;
+    ret |= flags & BufferMapFlag::MAP_INVALIDATE_RANGE ? GL_MAP_INVALIDATE_RANGE_BIT : 0;
+    ret |= flags & BufferMapFlag::MAP_INVALIDATE_BUFFER ? GL_MAP_INVALIDATE_BUFFER_BIT : 0;
+    ret |= flags & BufferMapFlag::MAP_FLUSH_EXPLICIT ? GL_MAP_FLUSH_EXPLICIT_BIT : 0;
+    ret |= flags & BufferMapFlag::MAP_UNSYNCHRONIZED ? GL_MAP_UNSYNCHRONIZED_BIT : 0;
     return ret;
   }
 
@@ -0,0 +1,436 @@
+#include <Fwog/detail/BindingStateTracker.h>
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <utility>
+
+namespace Fwog::detail
+{
+  namespace
+  {
+    // first index and count of the smallest range that covers every dirty slot
+    std::pair<uint32_t, uint32_t> DirtyRange(uint32_t dirty)
+    {
+      const auto first = static_cast<uint32_t>(std::countr_zero(dirty));
+      const auto last = static_cast<uint32_t>(std::bit_width(dirty));
+      return {first, last - first};
+    }
+
+    // every slot in the range is submitted, so none of them are dirty afterwards
+    uint32_t RangeMask(uint32_t first, uint32_t count)
+    {
+      return static_cast<uint32_t>(((uint64_t(1) << count) - 1) << first);
+    }
+
+    // bit i is set if slot i has nothing bound
+    template<size_t N>
+    uint32_t EmptySlots(const std::array<GLuint, N>& names)
+    {
+      uint32_t empty = 0;
+      for (uint32_t i = 0; i < N; i++)
+      {
+        empty |= static_cast<uint32_t>(names[i] == 0) << i;
+      }
+      return empty;
+    }
+
+    template<uint32_t N>
+    void SetBuffer(BufferBindingTable<N>& table,
+                   uint32_t index,
+                   GLuint buffer,
+                   GLintptr offset,
+                   GLsizeiptr size,
+                   bool wholeBuffer)
+    {
+      const uint32_t bit = 1u << index;
+      if (table.buffers[index] == buffer && table.offsets[index] == offset && table.sizes[index] == size &&
+          ((table.wholeBuffer & bit) != 0) == wholeBuffer)
+      {
+        return;
+      }
+
+      table.buffers[index] = buffer;
+      table.offsets[index] = offset;
+      table.sizes[index] = size;
+      table.wholeBuffer = wholeBuffer ? table.wholeBuffer | bit : table.wholeBuffer & ~bit;
+      table.dirty |= bit;
+    }
+
+    template<uint32_t N>
+    void SetBuffers(BufferBindingTable<N>& table,
+                    uint32_t mask,
+                    uint32_t wholeBuffer,
+                    const uint32_t* buffers,
+                    const int64_t* offsets,
+                    const int64_t* sizes)
+    {
+      size_t i = 0;
+      for (uint32_t slots = mask; slots != 0; slots &= slots - 1, i++)
+      {
+        const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+        SetBuffer(table,
+                  index,
+                  buffers[i],
+                  static_cast<GLintptr>(offsets[i]),
+                  static_cast<GLsizeiptr>(sizes[i]),
+                  (wholeBuffer & (1u << index)) != 0);
+      }
+    }
+
+    // Clean slots inside the range are rebound with their current values, which does not change any state.
+    // If blockSizes is given, slots bound with WHOLE_BUFFER are clamped to the size of the block declared at the slot.
+    template<uint32_t N>
+    void FlushBuffers(GLenum target,
+                      BufferBindingTable<N>& table,
+                      uint32_t used,
+                      const GLsizeiptr* blockSizes = nullptr)
+    {
+      if ((table.dirty & used) == 0)
+      {
+        return;
+      }
+
+      auto [first, count] = DirtyRange(table.dirty & used);
+      const GLsizeiptr* sizes = &table.sizes[first];
+
+      // only the block's size needs to be bound, which keeps the range within GL_MAX_UNIFORM_BLOCK_SIZE
+      std::array<GLsizeiptr, N> clampedSizes;
+      if (blockSizes && (table.wholeBuffer & RangeMask(first, count)) != 0)
+      {
+        for (uint32_t i = first; i < first + count; i++)
+        {
+          const bool clamp = (table.wholeBuffer & (1u << i)) != 0 && blockSizes[i] > 0;
+          clampedSizes[i] = clamp ? std::min(table.sizes[i], blockSizes[i]) : table.sizes[i];
+        }
+        sizes = &clampedSizes[first];
+      }
+
+      glBindBuffersRange(target, first, count, &table.buffers[first], &table.offsets[first], sizes);
+      table.dirty &= ~RangeMask(first, count);
+    }
+
+    // deleted objects are unbound by the context, so the shadow state is reset without marking anything dirty
+    template<uint32_t N>
+    void RemoveBufferFromTable(BufferBindingTable<N>& table, GLuint buffer)
+    {
+      for (uint32_t i = 0; i < N; i++)
+      {
+        if (table.buffers[i] == buffer)
+        {
+          table.buffers[i] = 0;
+          table.offsets[i] = 0;
+          table.sizes[i] = 0;
+          table.wholeBuffer &= ~(1u << i);
+        }
+      }
+    }
+  } // namespace
+
+  void BindingStateTracker::BindUniformBuffer(uint32_t index,
+                                              GLuint buffer,
+                                              GLintptr offset,
+                                              GLsizeiptr size,
+                                              bool wholeBuffer)
+  {
+    boundGroupHash_.reset();
+
+    if (index >= MAX_TRACKED_UNIFORM_BUFFERS)
+    {
+      glBindBufferRange(GL_UNIFORM_BUFFER, index, buffer, offset, size);
+      return;
+    }
+
+    SetBuffer(uniformBuffers_, index, buffer, offset, size, wholeBuffer);
+  }
+
+  void BindingStateTracker::BindStorageBuffer(uint32_t index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+  {
+    boundGroupHash_.reset();
+
+    if (index >= MAX_TRACKED_STORAGE_BUFFERS)
+    {
+      glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, buffer, offset, size);
+      return;
+    }
+
+    SetBuffer(storageBuffers_, index, buffer, offset, size, false);
+  }
+
+  void BindingStateTracker::BindSampledImage(uint32_t index, GLuint texture, GLuint sampler)
+  {
+    boundGroupHash_.reset();
+
+    if (index >= MAX_TRACKED_TEXTURE_UNITS)
+    {
+      glBindTextureUnit(index, texture);
+      glBindSampler(index, sampler);
+      return;
+    }
+
+    if (sampledImages_.textures[index] == texture && sampledImages_.samplers[index] == sampler)
+    {
+      return;
+    }
+
+    sampledImages_.textures[index] = texture;
+    sampledImages_.samplers[index] = sampler;
+    sampledImages_.dirty |= 1u << index;
+  }
+
+  void BindingStateTracker::BindImage(uint32_t index, GLuint texture, GLint level, GLenum format)
+  {
+    boundGroupHash_.reset();
+
+    if (index >= MAX_TRACKED_IMAGE_UNITS)
+    {
+      glBindImageTexture(index, texture, level, GL_TRUE, 0, GL_READ_WRITE, format);
+      return;
+    }
+
+    if (images_.textures[index] == texture && images_.levels[index] == level && images_.formats[index] == format)
+    {
+      return;
+    }
+
+    images_.textures[index] = texture;
+    images_.levels[index] = level;
+    images_.formats[index] = format;
+    images_.dirty |= 1u << index;
+  }
+
+  void BindingStateTracker::BindGroup(const Fwog::BindGroup& group)
+  {
+    if (boundGroupHash_ == group.Hash() && IsBound(group))
+    {
+      return;
+    }
+
+    SetBuffers(uniformBuffers_,
+               group.uniformBuffers_.mask,
+               group.uniformBuffers_.wholeBuffer,
+               group.uniformBuffers_.names.data(),
+               group.uniformBuffers_.offsets.data(),
+               group.uniformBuffers_.sizes.data());
+    SetBuffers(storageBuffers_,
+               group.storageBuffers_.mask,
+               group.storageBuffers_.wholeBuffer,
+               group.storageBuffers_.names.data(),
+               group.storageBuffers_.offsets.data(),
+               group.storageBuffers_.sizes.data());
+
+    size_t i = 0;
+    for (uint32_t slots = group.sampledImages_.mask; slots != 0; slots &= slots - 1, i++)
+    {
+      const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+      if (sampledImages_.textures[index] != group.sampledImages_.textures[i] ||
+          sampledImages_.samplers[index] != group.sampledImages_.samplers[i])
+      {
+        sampledImages_.textures[index] = group.sampledImages_.textures[i];
+        sampledImages_.samplers[index] = group.sampledImages_.samplers[i];
+        sampledImages_.dirty |= 1u << index;
+      }
+    }
+
+    i = 0;
+    for (uint32_t slots = group.images_.mask; slots != 0; slots &= slots - 1, i++)
+    {
+      const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+      const auto level = static_cast<GLint>(group.images_.levels[i]);
+      if (images_.textures[index] != group.images_.textures[i] || images_.levels[index] != level ||
+          images_.formats[index] != group.images_.formats[i])
+      {
+        images_.textures[index] = group.images_.textures[i];
+        images_.levels[index] = level;
+        images_.formats[index] = group.images_.formats[i];
+        images_.dirty |= 1u << index;
+      }
+    }
+
+    boundGroupHash_ = group.Hash();
+  }
+
+  bool BindingStateTracker::IsBound(const Fwog::BindGroup& group) const
+  {
+    auto buffersBound = [](const auto& table, const Fwog::BindGroup::Buffers& buffers)
+    {
+      if ((table.wholeBuffer & buffers.mask) != buffers.wholeBuffer)
+      {
+        return false;
+      }
+
+      size_t i = 0;
+      for (uint32_t slots = buffers.mask; slots != 0; slots &= slots - 1, i++)
+      {
+        const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+        if (table.buffers[index] != buffers.names[i] || table.offsets[index] != buffers.offsets[i] ||
+            table.sizes[index] != buffers.sizes[i])
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+
+    if (!buffersBound(uniformBuffers_, group.uniformBuffers_) || !buffersBound(storageBuffers_, group.storageBuffers_))
+    {
+      return false;
+    }
+
+    size_t i = 0;
+    for (uint32_t slots = group.sampledImages_.mask; slots != 0; slots &= slots - 1, i++)
+    {
+      const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+      if (sampledImages_.textures[index] != group.sampledImages_.textures[i] ||
+          sampledImages_.samplers[index] != group.sampledImages_.samplers[i])
+      {
+        return false;
+      }
+    }
+
+    i = 0;
+    for (uint32_t slots = group.images_.mask; slots != 0; slots &= slots - 1, i++)
+    {
+      const auto index = static_cast<uint32_t>(std::countr_zero(slots));
+      if (images_.textures[index] != group.images_.textures[i] ||
+          images_.levels[index] != static_cast<GLint>(group.images_.levels[i]) ||
+          images_.formats[index] != group.images_.formats[i])
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void BindingStateTracker::SetUsedSlots(const PipelineReflection& reflection)
+  {
+    usedUniformBuffers_ = reflection.uniformBufferMask;
+    usedStorageBuffers_ = reflection.storageBufferMask;
+    usedSampledImages_ = reflection.sampledImageMask;
+    usedImages_ = reflection.imageMask;
+
+    // slots bound with WHOLE_BUFFER are flushed again when the size they are clamped to changes
+    std::array<GLsizeiptr, MAX_TRACKED_UNIFORM_BUFFERS> blockSizes{};
+    for (const auto& block : reflection.uniformBlocks)
+    {
+      if (block.binding < MAX_TRACKED_UNIFORM_BUFFERS)
+      {
+        blockSizes[block.binding] = static_cast<GLsizeiptr>(block.dataSize);
+      }
+    }
+
+    for (uint32_t i = 0; i < MAX_TRACKED_UNIFORM_BUFFERS; i++)
+    {
+      if (blockSizes[i] != usedUniformBlockSizes_[i])
+      {
+        uniformBuffers_.dirty |= uniformBuffers_.wholeBuffer & (1u << i);
+      }
+    }
+    usedUniformBlockSizes_ = blockSizes;
+  }
+
+  void BindingStateTracker::Flush()
+  {
+#ifndef NDEBUG
+    ReportEmptySlots();
+#endif
+
+    FlushBuffers(GL_UNIFORM_BUFFER, uniformBuffers_, usedUniformBuffers_, usedUniformBlockSizes_.data());
+    FlushBuffers(GL_SHADER_STORAGE_BUFFER, storageBuffers_, usedStorageBuffers_);
+
+    if ((sampledImages_.dirty & usedSampledImages_) != 0)
+    {
+      auto [first, count] = DirtyRange(sampledImages_.dirty & usedSampledImages_);
+      glBindTextures(first, count, &sampledImages_.textures[first]);
+      glBindSamplers(first, count, &sampledImages_.samplers[first]);
+      sampledImages_.dirty &= ~RangeMask(first, count);
+    }
+
+    if ((images_.dirty & usedImages_) != 0)
+    {
+      auto [first, count] = DirtyRange(images_.dirty & usedImages_);
+
+      // glBindImageTextures always binds the base level with the texture's own format, layered, and read-write
+      bool canMultiBind = true;
+      for (uint32_t i = first; i < first + count; i++)
+      {
+        canMultiBind &= images_.levels[i] == 0;
+      }
+
+      if (canMultiBind)
+      {
+        glBindImageTextures(first, count, &images_.textures[first]);
+      }
+      else
+      {
+        for (uint32_t dirty = images_.dirty & RangeMask(first, count); dirty != 0; dirty &= dirty - 1)
+        {
+          const auto i = static_cast<uint32_t>(std::countr_zero(dirty));
+          glBindImageTexture(i, images_.textures[i], images_.levels[i], GL_TRUE, 0, GL_READ_WRITE, images_.formats[i]);
+        }
+      }
+      images_.dirty &= ~RangeMask(first, count);
+    }
+  }
+
+  // Reading an empty slot is not an error in GL, but is usually a missing bind. Some uses are deliberate (e.g. a
+  // texture that is only sampled for some materials), so this goes through debug output instead of asserting, and
+  // each set of empty slots is only reported once in a row.
+  void BindingStateTracker::ReportEmptySlots()
+  {
+    auto report = [](uint32_t empty, uint32_t& lastReported, const char* slotKind)
+    {
+      if (empty == 0 || empty == lastReported)
+      {
+        lastReported = empty;
+        return;
+      }
+      lastReported = empty;
+
+      std::string message = "The bound pipeline uses empty " + std::string(slotKind) + ":";
+      for (uint32_t i = empty; i != 0; i &= i - 1)
+      {
+        message += " " + std::to_string(std::countr_zero(i));
+      }
+      glDebugMessageInsert(GL_DEBUG_SOURCE_APPLICATION,
+                           GL_DEBUG_TYPE_OTHER,
+                           1,
+                           GL_DEBUG_SEVERITY_MEDIUM,
+                           static_cast<GLsizei>(message.size()),
+                           message.c_str());
+    };
+
+    report(EmptySlots(uniformBuffers_.buffers) & usedUniformBuffers_, lastReportedEmptySlots_[0], "uniform buffer slots");
+    report(EmptySlots(storageBuffers_.buffers) & usedStorageBuffers_, lastReportedEmptySlots_[1], "storage buffer slots");
+    report(EmptySlots(sampledImages_.textures) & usedSampledImages_, lastReportedEmptySlots_[2], "texture units");
+    report(EmptySlots(images_.textures) & usedImages_, lastReportedEmptySlots_[3], "image units");
+  }
+
+  void BindingStateTracker::RemoveBuffer(GLuint buffer)
+  {
+    boundGroupHash_.reset();
+    RemoveBufferFromTable(uniformBuffers_, buffer);
+    RemoveBufferFromTable(storageBuffers_, buffer);
+  }
+
+  void BindingStateTracker::RemoveTexture(GLuint texture)
+  {
+    boundGroupHash_.reset();
+    for (uint32_t i = 0; i < MAX_TRACKED_TEXTURE_UNITS; i++)
+    {
+      if (sampledImages_.textures[i] == texture)
+      {
+        sampledImages_.textures[i] = 0;
+      }
+    }
+
+    for (uint32_t i = 0; i < MAX_TRACKED_IMAGE_UNITS; i++)
+    {
+      if (images_.textures[i] == texture)
+      {
+        images_.textures[i] = 0;
+        images_.levels[i] = 0;
+      }
+    }
+  }
+} // namespace Fwog::detail
@@ -2,135 +2,254 @@
 #include "Fwog/Texture.h"
 #include "Fwog/detail/Hash.h"
 #include "Fwog/Common.h"
+#include <algorithm>
+#include <utility>
 
 namespace Fwog::detail
 {
-  uint32_t FramebufferCache::CreateOrGetCachedFramebuffer(const RenderInfo& renderInfo)
+  namespace
   {
-    RenderAttachments attachments;
-    for (const auto& colorAttachment : renderInfo.colorAttachments)
+    constexpr size_t INITIAL_SLOT_COUNT = 64;
+
+    FramebufferAttachmentKey MakeAttachmentKey(const RenderAttachment& attachment)
     {
-      attachments.colorAttachments.emplace_back(colorAttachment.texture->CreateInfo(), colorAttachment.texture->Handle());
+      const auto& createInfo = attachment.texture->CreateInfo();
+      FWOG_ASSERT(attachment.level < createInfo.mipLevels);
+      if (attachment.layer)
+      {
+        [[maybe_unused]] uint32_t layerCount = createInfo.arrayLayers;
+        if (createInfo.imageType == ImageType::TEX_CUBEMAP)
+        {
+          layerCount = 6;
+        }
+        else if (createInfo.imageType == ImageType::TEX_3D)
+        {
+          layerCount = std::max(createInfo.extent.depth >> attachment.level, 1u);
+        }
+        FWOG_ASSERT(*attachment.layer < layerCount);
+      }
+
+      return {
+        .texture = attachment.texture->Handle(),
+        .level = attachment.level,
+        .layer = attachment.layer.value_or(ALL_LAYERS),
+      };
     }
-    if (renderInfo.depthAttachment)
+
+    void AttachTexture(GLuint fbo, GLenum glAttachment, const FramebufferAttachmentKey& attachment)
     {
-      attachments.depthAttachment.emplace(renderInfo.depthAttachment->texture->CreateInfo(),
-                                          renderInfo.depthAttachment->texture->Handle());
+      if (attachment.layer == ALL_LAYERS)
+      {
+        glNamedFramebufferTexture(fbo, glAttachment, attachment.texture, static_cast<GLint>(attachment.level));
+      }
+      else
+      {
+        glNamedFramebufferTextureLayer(fbo,
+                                       glAttachment,
+                                       attachment.texture,
+                                       static_cast<GLint>(attachment.level),
+                                       static_cast<GLint>(attachment.layer));
+      }
     }
-    if (renderInfo.stencilAttachment)
+
+    FramebufferKey MakeKey(const RenderInfo& renderInfo)
     {
-      attachments.stencilAttachment.emplace(renderInfo.stencilAttachment->texture->CreateInfo(),
-                                            renderInfo.stencilAttachment->texture->Handle());
+      FWOG_ASSERT(renderInfo.colorAttachments.size() <= MAX_COLOR_ATTACHMENTS);
+
+      FramebufferKey key;
+      key.colorAttachmentCount = static_cast<uint32_t>(renderInfo.colorAttachments.size());
+      for (uint32_t i = 0; i < key.colorAttachmentCount; i++)
+      {
+        key.colorAttachments[i] = MakeAttachmentKey(renderInfo.colorAttachments[i]);
+      }
+      if (renderInfo.depthAttachment)
+      {
+        key.depthAttachment = MakeAttachmentKey(*renderInfo.depthAttachment);
+      }
+      if (renderInfo.stencilAttachment)
+      {
+        key.stencilAttachment = MakeAttachmentKey(*renderInfo.stencilAttachment);
+      }
+
+      key.hash = hashing::fnv1a(key.colorAttachments.data(),
+                                sizeof(FramebufferAttachmentKey) * key.colorAttachmentCount);
+      key.hash = hashing::fnv1a(&key.colorAttachmentCount, sizeof(key.colorAttachmentCount), key.hash);
+      key.hash = hashing::fnv1a(&key.depthAttachment, sizeof(key.depthAttachment), key.hash);
+      key.hash = hashing::fnv1a(&key.stencilAttachment, sizeof(key.stencilAttachment), key.hash);
+      return key;
     }
 
-    for (size_t i = 0; i < framebufferCacheKey_.size(); i++)
+    // calls f with each distinct texture in the key
+    template<typename F>
+    void ForEachTexture(const FramebufferKey& key, F&& f)
     {
-      if (framebufferCacheKey_[i] == attachments)
-        return framebufferCacheValue_[i];
+      std::array<uint32_t, MAX_COLOR_ATTACHMENTS + 2> textures{};
+      size_t textureCount = 0;
+      auto visit = [&](uint32_t texture)
+      {
+        if (texture != 0 &&
+            std::find(textures.begin(), textures.begin() + textureCount, texture) == textures.begin() + textureCount)
+        {
+          textures[textureCount++] = texture;
+          f(texture);
+        }
+      };
+
+      for (uint32_t i = 0; i < key.colorAttachmentCount; i++)
+      {
+        visit(key.colorAttachments[i].texture);
+      }
+      visit(key.depthAttachment.texture);
+      visit(key.stencilAttachment.texture);
+    }
+  } // namespace
+
+  uint32_t FramebufferCache::CreateOrGetCachedFramebuffer(const RenderInfo& renderInfo)
+  {
+    const auto key = MakeKey(renderInfo);
+
+    if (slots_.empty())
+    {
+      slots_.resize(INITIAL_SLOT_COUNT);
+    }
+
+    if (const auto& slot = FindSlot(key); slot.fbo != 0)
+    {
+      return slot.fbo;
     }
 
     uint32_t fbo{};
     glCreateFramebuffers(1, &fbo);
-    std::vector<GLenum> drawBuffers;
-    for (size_t i = 0; i < attachments.colorAttachments.size(); i++)
+    std::array<GLenum, MAX_COLOR_ATTACHMENTS> drawBuffers{};
+    for (uint32_t i = 0; i < key.colorAttachmentCount; i++)
     {
-      const auto& attachment = attachments.colorAttachments[i];
-      glNamedFramebufferTexture(fbo, static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i), attachment.id, 0);
-      drawBuffers.push_back(static_cast<GLenum>(GL_COLOR_ATTACHMENT0 + i));
+      AttachTexture(fbo, GL_COLOR_ATTACHMENT0 + i, key.colorAttachments[i]);
+      drawBuffers[i] = GL_COLOR_ATTACHMENT0 + i;
     }
-    glNamedFramebufferDrawBuffers(fbo, static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+    glNamedFramebufferDrawBuffers(fbo, static_cast<GLsizei>(key.colorAttachmentCount), drawBuffers.data());
 
-    if (attachments.depthAttachment && attachments.stencilAttachment &&
-        attachments.depthAttachment == attachments.stencilAttachment)
+    if (key.depthAttachment.texture != 0 && key.depthAttachment == key.stencilAttachment)
     {
-      glNamedFramebufferTexture(fbo, GL_DEPTH_STENCIL_ATTACHMENT, attachments.depthAttachment->id, 0);
+      AttachTexture(fbo, GL_DEPTH_STENCIL_ATTACHMENT, key.depthAttachment);
     }
-    else if (attachments.depthAttachment)
+    else if (key.depthAttachment.texture != 0)
     {
-      glNamedFramebufferTexture(fbo, GL_DEPTH_ATTACHMENT, attachments.depthAttachment->id, 0);
+      AttachTexture(fbo, GL_DEPTH_ATTACHMENT, key.depthAttachment);
     }
-    else if (attachments.stencilAttachment)
+    else if (key.stencilAttachment.texture != 0)
     {
-      glNamedFramebufferTexture(fbo, GL_STENCIL_ATTACHMENT, attachments.stencilAttachment->id, 0);
+      AttachTexture(fbo, GL_STENCIL_ATTACHMENT, key.stencilAttachment);
     }
 
-    framebufferCacheKey_.emplace_back(std::move(attachments));
-    return framebufferCacheValue_.emplace_back(fbo);
+    Insert(key, fbo);
+    ForEachTexture(key, [&](uint32_t texture) { textureFramebuffers_[texture].push_back(key); });
+    return fbo;
   }
 
   void FramebufferCache::Clear()
   {
-    for (const auto& fbo : framebufferCacheValue_)
+    for (auto& slot : slots_)
     {
-      glDeleteFramebuffers(1, &fbo);
+      if (slot.fbo != 0)
+      {
+        glDeleteFramebuffers(1, &slot.fbo);
+      }
+      slot = {};
     }
 
-    framebufferCacheKey_.clear();
-    framebufferCacheValue_.clear();
+    size_ = 0;
+    textureFramebuffers_.clear();
   }
 
-  // Must be called when a texture is deleted, otherwise the cache becomes invalid.
   void FramebufferCache::RemoveTexture(const Texture& texture)
   {
-    const TextureProxy texp = {texture.CreateInfo(), texture.Handle()};
+    auto it = textureFramebuffers_.find(texture.Handle());
+    if (it == textureFramebuffers_.end())
+    {
+      return;
+    }
 
-    for (size_t i = 0; i < framebufferCacheKey_.size(); i++)
+    // the node is detached so the other textures' lists can be modified while iterating
+    auto node = textureFramebuffers_.extract(it);
+    for (const auto& key : node.mapped())
     {
-      const auto& attachments = framebufferCacheKey_[i];
+      ForEachTexture(key,
+                     [&](uint32_t other)
+                     {
+                       if (auto otherIt = textureFramebuffers_.find(other); otherIt != textureFramebuffers_.end())
+                       {
+                         std::erase(otherIt->second, key);
+                         if (otherIt->second.empty())
+                         {
+                           textureFramebuffers_.erase(otherIt);
+                         }
+                       }
+                     });
+
+      auto& slot = FindSlot(key);
+      FWOG_ASSERT(slot.fbo != 0);
+      glDeleteFramebuffers(1, &slot.fbo);
+      Erase(key);
+    }
+  }
 
-      for (const auto& ci : attachments.colorAttachments)
+  FramebufferCache::Slot& FramebufferCache::FindSlot(const FramebufferKey& key)
+  {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = key.hash & mask;; i = (i + 1) & mask)
+    {
+      auto& slot = slots_[i];
+      if (slot.fbo == 0 || slot.key == key)
       {
-        if (texp == ci)
-        {
-          framebufferCacheKey_.erase(framebufferCacheKey_.begin() + i);
-          framebufferCacheValue_.erase(framebufferCacheValue_.begin() + i);
-          i--;
-        }
+        return slot;
       }
+    }
+  }
 
-      if (texp == attachments.depthAttachment)
-      {
-        framebufferCacheKey_.erase(framebufferCacheKey_.begin() + i);
-        framebufferCacheValue_.erase(framebufferCacheValue_.begin() + i);
-        i--;
-      }
+  void FramebufferCache::Insert(const FramebufferKey& key, uint32_t fbo)
+  {
+    // keep the load factor at or below one half so probe sequences stay short
+    if ((size_ + 1) * 2 > slots_.size())
+    {
+      Grow();
+    }
+
+    auto& slot = FindSlot(key);
+    FWOG_ASSERT(slot.fbo == 0);
+    slot = {key, fbo};
+    size_++;
+  }
+
+  // backward shift deletion, which leaves no tombstones behind
+  void FramebufferCache::Erase(const FramebufferKey& key)
+  {
+    const size_t mask = slots_.size() - 1;
+    size_t hole = static_cast<size_t>(&FindSlot(key) - slots_.data());
+    slots_[hole] = {};
+    size_--;
 
-      if (texp == attachments.stencilAttachment)
+    for (size_t i = (hole + 1) & mask; slots_[i].fbo != 0; i = (i + 1) & mask)
+    {
+      // an entry can fill the hole if its probe sequence starts at or before the hole
+      const size_t home = slots_[i].key.hash & mask;
+      if (((i - home) & mask) >= ((i - hole) & mask))
       {
-        framebufferCacheKey_.erase(framebufferCacheKey_.begin() + i);
-        framebufferCacheValue_.erase(framebufferCacheValue_.begin() + i);
-        i--;
+        slots_[hole] = slots_[i];
+        slots_[i] = {};
+        hole = i;
       }
     }
   }
 
-  bool RenderAttachments::operator==(const RenderAttachments& rhs) const
+  void FramebufferCache::Grow()
   {
-    if (colorAttachments.size() != rhs.colorAttachments.size())
-      return false;
-
-    // Crucially, two attachments with the same address are not necessarily the same.
-    // The inverse is also true: two attachments with different addresses are not necessarily different.
-
-    for (size_t i = 0; i < colorAttachments.size(); i++)
+    auto oldSlots = std::exchange(slots_, std::vector<Slot>(std::max(slots_.size() * 2, INITIAL_SLOT_COUNT)));
+    for (const auto& slot : oldSlots)
     {
-      // Color attachments must be non-null
-      if (colorAttachments[i] != rhs.colorAttachments[i])
-        return false;
+      if (slot.fbo != 0)
+      {
+        FindSlot(slot.key) = slot;
+      }
     }
-
-    // Nullness of the attachments differ
-    if ((depthAttachment && !rhs.depthAttachment) || (!depthAttachment && rhs.depthAttachment))
-      return false;
-    // Both attachments are non-null, but have different values
-    if (depthAttachment && rhs.depthAttachment && (*depthAttachment != *rhs.depthAttachment))
-      return false;
-
-    if ((stencilAttachment && !rhs.stencilAttachment) || (!stencilAttachment && rhs.stencilAttachment))
-      return false;
-    if (stencilAttachment && rhs.stencilAttachment && (*stencilAttachment != *rhs.stencilAttachment))
-      return false;
-
-    return true;
   }
 } // namespace Fwog::detail
@@ -0,0 +1,254 @@
+#include <Fwog/Common.h>
+#include <Fwog/detail/OffsetAllocator.h>
+#include <algorithm>
+#include <bit>
+
+namespace Fwog::detail
+{
+  namespace
+  {
+    constexpr uint32_t MANTISSA_BITS = 3;
+    constexpr uint32_t MANTISSA_VALUE = 1u << MANTISSA_BITS;
+    constexpr uint32_t MANTISSA_MASK = MANTISSA_VALUE - 1;
+
+    // Sizes below MANTISSA_VALUE have a bin each. Larger sizes share a bin with the sizes that have the same exponent
+    // and leading mantissa bits, so every bin holds sizes within 1/8 of each other.
+    uint32_t SizeToBinRoundDown(uint32_t size)
+    {
+      if (size < MANTISSA_VALUE)
+      {
+        return size;
+      }
+
+      const auto shift = static_cast<uint32_t>(std::bit_width(size)) - 1 - MANTISSA_BITS;
+      return ((shift + 1) << MANTISSA_BITS) | ((size >> shift) & MANTISSA_MASK);
+    }
+
+    // the first bin whose ranges are all at least size
+    uint32_t SizeToBinRoundUp(uint32_t size)
+    {
+      const uint32_t bin = SizeToBinRoundDown(size);
+      if (size < MANTISSA_VALUE)
+      {
+        return bin;
+      }
+
+      const auto shift = static_cast<uint32_t>(std::bit_width(size)) - 1 - MANTISSA_BITS;
+      return (size & ((1u << shift) - 1)) != 0 ? bin + 1 : bin;
+    }
+  } // namespace
+
+  OffsetAllocator::OffsetAllocator(uint32_t size) : size_(size)
+  {
+    Reset();
+  }
+
+  std::optional<OffsetAllocator::Allocation> OffsetAllocator::Allocate(uint32_t size)
+  {
+    FWOG_ASSERT(size > 0);
+
+    // find the first non-empty bin that can hold the request, in this group or a later one
+    const uint32_t minBin = SizeToBinRoundUp(size);
+    uint32_t group = minBin / BINS_PER_GROUP;
+    if (group >= GROUP_COUNT)
+    {
+      return std::nullopt;
+    }
+
+    uint32_t bins = binMasks_[group] & (0xFFu << (minBin % BINS_PER_GROUP));
+    if (bins == 0)
+    {
+      const uint32_t groups = group + 1 < GROUP_COUNT ? groupMask_ & (~0u << (group + 1)) : 0;
+      if (groups == 0)
+      {
+        return std::nullopt;
+      }
+
+      group = static_cast<uint32_t>(std::countr_zero(groups));
+      bins = binMasks_[group];
+    }
+
+    return UseFreeNode(binHeads_[group * BINS_PER_GROUP + static_cast<uint32_t>(std::countr_zero(bins))], size);
+  }
+
+  OffsetAllocator::Allocation OffsetAllocator::UseFreeNode(uint32_t node, uint32_t size)
+  {
+    FWOG_ASSERT(!nodes_[node].used && nodes_[node].size >= size);
+    RemoveFreeNode(node);
+
+    // the rest of the range stays free
+    if (nodes_[node].size > size)
+    {
+      const uint32_t remainder = CreateNode(nodes_[node].offset + size, nodes_[node].size - size);
+      const uint32_t next = nodes_[node].neighborNext;
+      nodes_[remainder].neighborPrev = node;
+      nodes_[remainder].neighborNext = next;
+      if (next != INVALID_NODE)
+      {
+        nodes_[next].neighborPrev = remainder;
+      }
+      nodes_[node].neighborNext = remainder;
+      nodes_[node].size = size;
+      InsertFreeNode(remainder);
+    }
+
+    nodes_[node].used = true;
+    return Allocation{nodes_[node].offset, node};
+  }
+
+  void OffsetAllocator::Free(uint32_t node)
+  {
+    FWOG_ASSERT(node < nodes_.size() && nodes_[node].used && "The allocation was already freed");
+    nodes_[node].used = false;
+
+    if (const uint32_t prev = nodes_[node].neighborPrev; prev != INVALID_NODE && !nodes_[prev].used)
+    {
+      RemoveFreeNode(prev);
+      const uint32_t next = nodes_[node].neighborNext;
+      nodes_[prev].size += nodes_[node].size;
+      nodes_[prev].neighborNext = next;
+      if (next != INVALID_NODE)
+      {
+        nodes_[next].neighborPrev = prev;
+      }
+      nodes_[node] = {};
+      unusedNodes_.push_back(node);
+      node = prev;
+    }
+
+    if (const uint32_t next = nodes_[node].neighborNext; next != INVALID_NODE && !nodes_[next].used)
+    {
+      RemoveFreeNode(next);
+      const uint32_t nextNext = nodes_[next].neighborNext;
+      nodes_[node].size += nodes_[next].size;
+      nodes_[node].neighborNext = nextNext;
+      if (nextNext != INVALID_NODE)
+      {
+        nodes_[nextNext].neighborPrev = node;
+      }
+      nodes_[next] = {};
+      unusedNodes_.push_back(next);
+    }
+
+    InsertFreeNode(node);
+  }
+
+  void OffsetAllocator::Reset()
+  {
+    nodes_.clear();
+    unusedNodes_.clear();
+    binHeads_.fill(INVALID_NODE);
+    binMasks_.fill(0);
+    groupMask_ = 0;
+    freeSize_ = 0;
+
+    if (size_ > 0)
+    {
+      InsertFreeNode(CreateNode(0, size_));
+    }
+  }
+
+  std::vector<OffsetAllocator::Allocation> OffsetAllocator::ResetPacked(std::span<const uint32_t> sizes)
+  {
+    Reset();
+
+    // after a reset, the only node is the free range covering the whole resource
+    std::vector<Allocation> allocations;
+    allocations.reserve(sizes.size());
+    uint32_t tail = nodes_.empty() ? INVALID_NODE : 0;
+    for (uint32_t size : sizes)
+    {
+      FWOG_ASSERT(size > 0);
+      FWOG_ASSERT(tail != INVALID_NODE && nodes_[tail].size >= size && "The ranges do not fit in the resource");
+      allocations.push_back(UseFreeNode(tail, size));
+      tail = nodes_[allocations.back().node].neighborNext;
+    }
+    return allocations;
+  }
+
+  uint32_t OffsetAllocator::LargestFreeRange() const
+  {
+    if (groupMask_ == 0)
+    {
+      return 0;
+    }
+
+    // ranges in the highest non-empty bin are larger than any other, but not sorted among themselves
+    const auto group = static_cast<uint32_t>(std::bit_width(groupMask_)) - 1;
+    const auto bin = group * BINS_PER_GROUP + static_cast<uint32_t>(std::bit_width(binMasks_[group])) - 1;
+    uint32_t largest = 0;
+    for (uint32_t node = binHeads_[bin]; node != INVALID_NODE; node = nodes_[node].binNext)
+    {
+      largest = std::max(largest, nodes_[node].size);
+    }
+    return largest;
+  }
+
+  uint32_t OffsetAllocator::CreateNode(uint32_t offset, uint32_t size)
+  {
+    uint32_t node;
+    if (!unusedNodes_.empty())
+    {
+      node = unusedNodes_.back();
+      unusedNodes_.pop_back();
+    }
+    else
+    {
+      node = static_cast<uint32_t>(nodes_.size());
+      nodes_.emplace_back();
+    }
+
+    nodes_[node] = {.offset = offset, .size = size};
+    return node;
+  }
+
+  void OffsetAllocator::InsertFreeNode(uint32_t node)
+  {
+    const uint32_t bin = SizeToBinRoundDown(nodes_[node].size);
+    const uint32_t head = binHeads_[bin];
+    nodes_[node].binPrev = INVALID_NODE;
+    nodes_[node].binNext = head;
+    if (head != INVALID_NODE)
+    {
+      nodes_[head].binPrev = node;
+    }
+    binHeads_[bin] = node;
+
+    binMasks_[bin / BINS_PER_GROUP] |= static_cast<uint8_t>(1u << (bin % BINS_PER_GROUP));
+    groupMask_ |= 1u << (bin / BINS_PER_GROUP);
+    freeSize_ += nodes_[node].size;
+  }
+
+  // must be called before the node's size changes, since the size determines its bin
+  void OffsetAllocator::RemoveFreeNode(uint32_t node)
+  {
+    const uint32_t bin = SizeToBinRoundDown(nodes_[node].size);
+    const uint32_t prev = nodes_[node].binPrev;
+    const uint32_t next = nodes_[node].binNext;
+    if (prev != INVALID_NODE)
+    {
+      nodes_[prev].binNext = next;
+    }
+    else
+    {
+      binHeads_[bin] = next;
+    }
+    if (next != INVALID_NODE)
+    {
+      nodes_[next].binPrev = prev;
+    }
+    nodes_[node].binPrev = INVALID_NODE;
+    nodes_[node].binNext = INVALID_NODE;
+
+    if (binHeads_[bin] == INVALID_NODE)
+    {
+      const uint32_t group = bin / BINS_PER_GROUP;
+      binMasks_[group] &= static_cast<uint8_t>(~(1u << (bin % BINS_PER_GROUP)));
+      if (binMasks_[group] == 0)
+      {
+        groupMask_ &= ~(1u << group);
+      }
+    }
+    freeSize_ -= nodes_[node].size;
+  }
+} // namespace Fwog::detail
@@ -1,16 +1,132 @@
 #include <Fwog/Common.h>
 #include <Fwog/Exception.h>
+#include <Fwog/PipelineCache.h>
 #include <Fwog/Shader.h>
 #include <Fwog/detail/Hash.h>
 #include <Fwog/detail/PipelineManager.h>
+#include <Fwog/detail/ProgramReflection.h>
+#include <Fwog/detail/SlotMap.h>
+#include <Fwog/detail/VertexArrayCache.h>
+#include <algorithm>
 #include <unordered_map>
 
 namespace Fwog::detail
 {
   namespace
   {
-    std::unordered_map<GLuint, std::shared_ptr<const GraphicsPipelineInfoOwning>> gGraphicsPipelines;
-    std::unordered_map<GLuint, std::shared_ptr<const ComputePipelineInfoOwning>> gComputePipelines;
+    SlotMap<GraphicsPipelineInfoOwning> gGraphicsPipelines;
+    SlotMap<ComputePipelineInfoOwning> gComputePipelines;
+
+    struct ColorBlendGlobalState
+    {
+      bool blendEnable;
+      bool logicOpEnable;
+      LogicOp logicOp;
+      std::array<float, 4> blendConstants;
+
+      bool operator==(const ColorBlendGlobalState&) const noexcept = default;
+    };
+
+    // multisample state is applied with the rasterization group, as it rarely changes independently
+    struct RasterizationGlobalState
+    {
+      RasterizationState rasterization;
+      MultisampleState multisample;
+
+      bool operator==(const RasterizationGlobalState&) const noexcept = default;
+    };
+
+    // interned state groups, indexed by id - 1
+    std::vector<InputAssemblyState> gInputAssemblyStates;
+    std::vector<std::vector<VertexInputBindingDescription>> gVertexInputStates;
+    std::vector<RasterizationGlobalState> gRasterizationStates;
+    std::vector<RasterizationState> gDepthBiasStates;
+    std::vector<DepthState> gDepthStates;
+    std::vector<StencilState> gStencilStates;
+    std::vector<ColorBlendGlobalState> gColorBlendStates;
+    std::vector<ColorBlendAttachmentState> gColorBlendAttachmentStates;
+    uint32_t gNextPipelineSerial = 1;
+
+    // vertex arrays are shared by every pipeline with the same vertex input state
+    VertexArrayCache gVertexArrayCache;
+
+    // asynchronously linked programs that are added to the pipeline cache once their link status is checked
+    std::unordered_map<GLuint, PipelineCacheKey> gPendingCacheStores;
+
+    // there are few distinct states in practice, so a linear search is fine
+    template<typename T>
+    uint32_t InternState(std::vector<T>& states, const T& state)
+    {
+      auto it = std::find(states.begin(), states.end(), state);
+      if (it == states.end())
+      {
+        states.push_back(state);
+        return static_cast<uint32_t>(states.size());
+      }
+      return static_cast<uint32_t>(it - states.begin()) + 1;
+    }
+
+    // State that BindGraphicsPipeline does not apply for a group, or tracks separately (write masks), is normalized so
+    // it cannot produce distinct ids.
+    GraphicsPipelineStateBlock MakeStateBlock(const GraphicsPipelineInfoOwning& info)
+    {
+      GraphicsPipelineStateBlock block{.serial = gNextPipelineSerial++};
+      auto group = [&block](PipelineStateGroup group) -> uint32_t& { return block.groups[static_cast<size_t>(group)]; };
+
+      // topology is a draw parameter rather than state
+      group(PipelineStateGroup::INPUT_ASSEMBLY) = InternState(
+        gInputAssemblyStates,
+        InputAssemblyState{.primitiveRestartEnable = info.inputAssemblyState.primitiveRestartEnable});
+
+      group(PipelineStateGroup::VERTEX_INPUT) =
+        InternState(gVertexInputStates, info.vertexInputState.vertexBindingDescriptions);
+
+      const auto& rs = info.rasterizationState;
+      auto rasterization = rs;
+      rasterization.depthBiasEnable = false;
+      rasterization.depthBiasConstantFactor = 0;
+      rasterization.depthBiasSlopeFactor = 0;
+      auto multisample = info.multisampleState;
+      multisample.minSampleShading = multisample.sampleShadingEnable ? multisample.minSampleShading : 1;
+      group(PipelineStateGroup::RASTERIZATION) =
+        InternState(gRasterizationStates, RasterizationGlobalState{rasterization, multisample});
+      group(PipelineStateGroup::DEPTH_BIAS) = InternState(gDepthBiasStates,
+                                                          RasterizationState{
+                                                            .depthBiasEnable = rs.depthBiasEnable,
+                                                            .depthBiasConstantFactor = rs.depthBiasConstantFactor,
+                                                            .depthBiasSlopeFactor = rs.depthBiasSlopeFactor,
+                                                          });
+
+      auto depth = info.depthState.depthTestEnable ? info.depthState : DepthState{};
+      depth.depthWriteEnable = false;
+      group(PipelineStateGroup::DEPTH) = InternState(gDepthStates, depth);
+
+      auto stencil = info.stencilState.stencilTestEnable ? info.stencilState : StencilState{};
+      stencil.front.writeMask = 0;
+      stencil.back.writeMask = 0;
+      group(PipelineStateGroup::STENCIL) = InternState(gStencilStates, stencil);
+
+      const auto& cb = info.colorBlendState;
+      group(PipelineStateGroup::COLOR_BLEND) = InternState(gColorBlendStates,
+                                                           ColorBlendGlobalState{
+                                                             .blendEnable = !cb.attachments.empty(),
+                                                             .logicOpEnable = cb.logicOpEnable,
+                                                             .logicOp = cb.logicOpEnable ? cb.logicOp : LogicOp{},
+                                                             .blendConstants = {cb.blendConstants[0],
+                                                                                cb.blendConstants[1],
+                                                                                cb.blendConstants[2],
+                                                                                cb.blendConstants[3]},
+                                                           });
+
+      for (size_t i = 0; i < cb.attachments.size(); i++)
+      {
+        auto attachment = cb.attachments[i].blendEnable ? cb.attachments[i] : ColorBlendAttachmentState{};
+        attachment.colorWriteMask = ColorComponentFlag::NONE;
+        block.colorBlendAttachments[i] = InternState(gColorBlendAttachmentStates, attachment);
+      }
+
+      return block;
+    }
 
     GraphicsPipelineInfoOwning MakePipelineInfoOwning(const GraphicsPipelineInfo& info)
     {
@@ -20,6 +136,7 @@ namespace Fwog::detail
         .vertexInputState = {{info.vertexInputState.vertexBindingDescriptions.begin(),
                               info.vertexInputState.vertexBindingDescriptions.end()}},
         .rasterizationState = info.rasterizationState,
+        .multisampleState = info.multisampleState,
         .depthState = info.depthState,
         .stencilState = info.stencilState,
         .colorBlendState{
@@ -34,13 +151,13 @@ namespace Fwog::detail
               info.colorBlendState.blendConstants[3],
             },
         },
+        .warmupColorFormats = {info.warmupColorFormats.begin(), info.warmupColorFormats.end()},
       };
     }
 
-    bool LinkProgram(GLuint program, std::string& outInfoLog)
+    // blocks until the program has finished linking
+    bool GetLinkStatus(GLuint program, std::string& outInfoLog)
     {
-      glLinkProgram(program);
-
       GLint success{};
       glGetProgramiv(program, GL_LINK_STATUS, &success);
       if (!success)
@@ -53,101 +170,211 @@ namespace Fwog::detail
 
       return true;
     }
+
+    // Starts linking the program. Unless async is true, waits for the result and throws if linking failed.
+    // The binary is added to the pipeline cache if one is set.
+    void LinkProgram(GLuint program, const PipelineCacheKey& cacheKey, bool async, std::string_view errorMessage)
+    {
+      auto* cache = GetPipelineCache();
+      if (cache)
+      {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+      }
+
+      glLinkProgram(program);
+
+      if (async)
+      {
+        if (cache)
+        {
+          gPendingCacheStores[program] = cacheKey;
+        }
+        return;
+      }
+
+      std::string infolog;
+      if (!GetLinkStatus(program, infolog))
+      {
+        glDeleteProgram(program);
+        throw PipelineCompilationException(std::string(errorMessage) + infolog);
+      }
+
+      if (cache)
+      {
+        cache->StoreProgram(cacheKey, program);
+      }
+    }
+
+    GLuint LoadCachedProgram(const PipelineCacheKey& cacheKey)
+    {
+      auto* cache = GetPipelineCache();
+      return cache ? cache->LoadProgram(cacheKey) : 0;
+    }
   } // namespace
 
-  uint64_t CompileGraphicsPipelineInternal(const GraphicsPipelineInfo& info)
+  uint64_t CompileGraphicsPipelineInternal(const GraphicsPipelineInfo& info, bool async)
   {
     FWOG_ASSERT(info.vertexShader && "A graphics pipeline must at least have a vertex shader");
-    GLuint program = glCreateProgram();
-    glAttachShader(program, info.vertexShader->Handle());
-    if (info.fragmentShader)
+    FWOG_ASSERT(info.colorBlendState.attachments.size() <= MAX_COLOR_ATTACHMENTS);
+    FWOG_ASSERT(info.warmupColorFormats.size() <= MAX_COLOR_ATTACHMENTS);
+
+    const PipelineCacheKey cacheKey{
+      .shaderHashes = {info.vertexShader->SourceHash(), info.fragmentShader ? info.fragmentShader->SourceHash() : 0},
+      .shaderSizes = {info.vertexShader->SourceSize(), info.fragmentShader ? info.fragmentShader->SourceSize() : 0},
+    };
+
+    GLuint program = LoadCachedProgram(cacheKey);
+    if (!program)
     {
-      glAttachShader(program, info.fragmentShader->Handle());
+      // shader compilation may be deferred and throw, so get the handles before creating the program
+      const GLuint vertexShader = info.vertexShader->Handle();
+      const GLuint fragmentShader = info.fragmentShader ? info.fragmentShader->Handle() : 0;
+
+      program = glCreateProgram();
+      glAttachShader(program, vertexShader);
+      if (fragmentShader)
+      {
+        glAttachShader(program, fragmentShader);
+      }
+
+      LinkProgram(program, cacheKey, async, "Failed to compile graphics pipeline.\n");
     }
 
-    std::string infolog;
-    if (!LinkProgram(program, infolog))
+    auto owning = MakePipelineInfoOwning(info);
+    owning.program = program;
+    owning.stateBlock = MakeStateBlock(owning);
+    owning.vertexArray =
+      gVertexArrayCache.CreateOrGetCachedVertexArray(owning.vertexInputState.vertexBindingDescriptions);
+    owning.reflection =
+      std::make_unique<PipelineReflection>(async ? PipelineReflection{} : ReflectProgram(program, false));
+    return gGraphicsPipelines.Insert(std::move(owning));
+  }
+
+  void RemoveBufferFromVertexArraysInternal(uint32_t buffer)
+  {
+    gVertexArrayCache.RemoveBuffer(buffer);
+  }
+
+  void EnableParallelCompilationInternal()
+  {
+    static bool enabled = false;
+    if (!enabled && GLAD_GL_KHR_parallel_shader_compile)
     {
-      glDeleteProgram(program);
-      throw PipelineCompilationException("Failed to compile graphics pipeline.\n" + infolog);
+      // let the driver use as many threads as it wants
+      glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
     }
+    enabled = true;
+  }
 
-    if (auto it = gGraphicsPipelines.find(program); it != gGraphicsPipelines.end())
+  bool IsProgramLinkCompleteInternal(uint32_t program)
+  {
+    if (!GLAD_GL_KHR_parallel_shader_compile)
     {
-      return it->first;
+      return true;
     }
 
-    auto owning = MakePipelineInfoOwning(info);
-    gGraphicsPipelines.insert({program, std::make_shared<const GraphicsPipelineInfoOwning>(std::move(owning))});
-    return program;
+    GLint complete{};
+    glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete != 0;
   }
 
-  std::shared_ptr<const GraphicsPipelineInfoOwning> GetGraphicsPipelineInternal(uint64_t pipeline)
+  void CheckProgramLinkStatusInternal(uint32_t program)
   {
-    if (auto it = gGraphicsPipelines.find(static_cast<GLuint>(pipeline)); it != gGraphicsPipelines.end())
+    std::string infolog;
+    const bool success = GetLinkStatus(program, infolog);
+
+    if (auto it = gPendingCacheStores.find(program); it != gPendingCacheStores.end())
     {
-      return it->second;
+      if (auto* cache = GetPipelineCache(); success && cache)
+      {
+        cache->StoreProgram(it->second, program);
+      }
+      gPendingCacheStores.erase(it);
+    }
+
+    if (!success)
+    {
+      throw PipelineCompilationException("Failed to compile pipeline.\n" + infolog);
     }
-    return nullptr;
   }
 
+  const GraphicsPipelineInfoOwning* GetGraphicsPipelineInternal(uint64_t pipeline)
+  {
+    return gGraphicsPipelines.Get(pipeline);
+  }
+
+  // A program that is still in use is only flagged for deletion by the driver, so the last bound pipeline can be
+  // destroyed immediately. Its handle can never resolve to a newer pipeline.
   void DestroyGraphicsPipelineInternal(uint64_t pipeline)
   {
-    auto it = gGraphicsPipelines.find(static_cast<GLuint>(pipeline));
-    if (it == gGraphicsPipelines.end())
+    auto owning = gGraphicsPipelines.Erase(pipeline);
+    if (!owning)
     {
       // Tried to delete a nonexistent pipeline.
       FWOG_UNREACHABLE;
       return;
     }
 
-    glDeleteProgram(static_cast<GLuint>(pipeline));
-    gGraphicsPipelines.erase(it);
+    gPendingCacheStores.erase(owning->program);
+    glDeleteProgram(owning->program);
+  }
+
+  void ReflectGraphicsPipelineInternal(uint64_t pipeline)
+  {
+    auto* owning = gGraphicsPipelines.Get(pipeline);
+    FWOG_ASSERT(owning);
+    *owning->reflection = ReflectProgram(owning->program, false);
   }
 
-  uint64_t CompileComputePipelineInternal(const ComputePipelineInfo& info)
+  uint64_t CompileComputePipelineInternal(const ComputePipelineInfo& info, bool async)
   {
     FWOG_ASSERT(info.shader);
-    GLuint program = glCreateProgram();
-    glAttachShader(program, info.shader->Handle());
 
-    std::string infolog;
-    if (!LinkProgram(program, infolog))
-    {
-      glDeleteProgram(program);
-      throw PipelineCompilationException("Failed to compile compute pipeline.\n" + infolog);
-    }
+    const PipelineCacheKey cacheKey{
+      .shaderHashes = {info.shader->SourceHash(), 0},
+      .shaderSizes = {info.shader->SourceSize(), 0},
+    };
 
-    if (auto it = gComputePipelines.find(program); it != gComputePipelines.end())
+    GLuint program = LoadCachedProgram(cacheKey);
+    if (!program)
     {
-      return it->first;
+      const GLuint shader = info.shader->Handle();
+
+      program = glCreateProgram();
+      glAttachShader(program, shader);
+      LinkProgram(program, cacheKey, async, "Failed to compile compute pipeline.\n");
     }
 
-    auto owning = ComputePipelineInfoOwning{.name = std::string(info.name)};
-    gComputePipelines.insert({program, std::make_shared<const ComputePipelineInfoOwning>()});
-    return program;
+    return gComputePipelines.Insert(ComputePipelineInfoOwning{
+      .program = program,
+      .name = std::string(info.name),
+      .reflection = std::make_unique<PipelineReflection>(async ? PipelineReflection{} : ReflectProgram(program, true)),
+    });
   }
 
-  std::shared_ptr<const ComputePipelineInfoOwning> GetComputePipelineInternal(uint64_t pipeline)
+  const ComputePipelineInfoOwning* GetComputePipelineInternal(uint64_t pipeline)
   {
-    if (auto it = gComputePipelines.find(static_cast<GLuint>(pipeline)); it != gComputePipelines.end())
-    {
-      return it->second;
-    }
-    return nullptr;
+    return gComputePipelines.Get(pipeline);
+  }
+
+  void ReflectComputePipelineInternal(uint64_t pipeline)
+  {
+    auto* owning = gComputePipelines.Get(pipeline);
+    FWOG_ASSERT(owning);
+    *owning->reflection = ReflectProgram(owning->program, true);
   }
 
   void DestroyComputePipelineInternal(uint64_t pipeline)
   {
-    auto it = gComputePipelines.find(static_cast<GLuint>(pipeline));
-    if (it == gComputePipelines.end())
+    auto owning = gComputePipelines.Erase(pipeline);
+    if (!owning)
     {
       // Tried to delete a nonexistent pipeline.
       FWOG_UNREACHABLE;
       return;
     }
 
-    glDeleteProgram(static_cast<GLuint>(pipeline));
-    gComputePipelines.erase(it);
+    gPendingCacheStores.erase(owning->program);
+    glDeleteProgram(owning->program);
   }
 } // namespace Fwog::detail
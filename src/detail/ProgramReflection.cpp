@@ -0,0 +1,229 @@
+#include <Fwog/Common.h>
+#include <Fwog/detail/ProgramReflection.h>
+#include <algorithm>
+#include <array>
+#include <string>
+
+namespace Fwog::detail
+{
+  namespace
+  {
+    constexpr std::array SAMPLER_TYPES = {
+      GL_SAMPLER_1D,
+      GL_SAMPLER_2D,
+      GL_SAMPLER_3D,
+      GL_SAMPLER_CUBE,
+      GL_SAMPLER_1D_SHADOW,
+      GL_SAMPLER_2D_SHADOW,
+      GL_SAMPLER_1D_ARRAY,
+      GL_SAMPLER_2D_ARRAY,
+      GL_SAMPLER_1D_ARRAY_SHADOW,
+      GL_SAMPLER_2D_ARRAY_SHADOW,
+      GL_SAMPLER_2D_MULTISAMPLE,
+      GL_SAMPLER_2D_MULTISAMPLE_ARRAY,
+      GL_SAMPLER_CUBE_SHADOW,
+      GL_SAMPLER_BUFFER,
+      GL_SAMPLER_2D_RECT,
+      GL_SAMPLER_2D_RECT_SHADOW,
+      GL_SAMPLER_CUBE_MAP_ARRAY,
+      GL_SAMPLER_CUBE_MAP_ARRAY_SHADOW,
+      GL_INT_SAMPLER_1D,
+      GL_INT_SAMPLER_2D,
+      GL_INT_SAMPLER_3D,
+      GL_INT_SAMPLER_CUBE,
+      GL_INT_SAMPLER_1D_ARRAY,
+      GL_INT_SAMPLER_2D_ARRAY,
+      GL_INT_SAMPLER_2D_MULTISAMPLE,
+      GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,
+      GL_INT_SAMPLER_BUFFER,
+      GL_INT_SAMPLER_2D_RECT,
+      GL_INT_SAMPLER_CUBE_MAP_ARRAY,
+      GL_UNSIGNED_INT_SAMPLER_1D,
+      GL_UNSIGNED_INT_SAMPLER_2D,
+      GL_UNSIGNED_INT_SAMPLER_3D,
+      GL_UNSIGNED_INT_SAMPLER_CUBE,
+      GL_UNSIGNED_INT_SAMPLER_1D_ARRAY,
+      GL_UNSIGNED_INT_SAMPLER_2D_ARRAY,
+      GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE,
+      GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY,
+      GL_UNSIGNED_INT_SAMPLER_BUFFER,
+      GL_UNSIGNED_INT_SAMPLER_2D_RECT,
+      GL_UNSIGNED_INT_SAMPLER_CUBE_MAP_ARRAY,
+    };
+
+    constexpr std::array IMAGE_TYPES = {
+      GL_IMAGE_1D,
+      GL_IMAGE_2D,
+      GL_IMAGE_3D,
+      GL_IMAGE_2D_RECT,
+      GL_IMAGE_CUBE,
+      GL_IMAGE_BUFFER,
+      GL_IMAGE_1D_ARRAY,
+      GL_IMAGE_2D_ARRAY,
+      GL_IMAGE_CUBE_MAP_ARRAY,
+      GL_IMAGE_2D_MULTISAMPLE,
+      GL_IMAGE_2D_MULTISAMPLE_ARRAY,
+      GL_INT_IMAGE_1D,
+      GL_INT_IMAGE_2D,
+      GL_INT_IMAGE_3D,
+      GL_INT_IMAGE_2D_RECT,
+      GL_INT_IMAGE_CUBE,
+      GL_INT_IMAGE_BUFFER,
+      GL_INT_IMAGE_1D_ARRAY,
+      GL_INT_IMAGE_2D_ARRAY,
+      GL_INT_IMAGE_CUBE_MAP_ARRAY,
+      GL_INT_IMAGE_2D_MULTISAMPLE,
+      GL_INT_IMAGE_2D_MULTISAMPLE_ARRAY,
+      GL_UNSIGNED_INT_IMAGE_1D,
+      GL_UNSIGNED_INT_IMAGE_2D,
+      GL_UNSIGNED_INT_IMAGE_3D,
+      GL_UNSIGNED_INT_IMAGE_2D_RECT,
+      GL_UNSIGNED_INT_IMAGE_CUBE,
+      GL_UNSIGNED_INT_IMAGE_BUFFER,
+      GL_UNSIGNED_INT_IMAGE_1D_ARRAY,
+      GL_UNSIGNED_INT_IMAGE_2D_ARRAY,
+      GL_UNSIGNED_INT_IMAGE_CUBE_MAP_ARRAY,
+      GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE,
+      GL_UNSIGNED_INT_IMAGE_2D_MULTISAMPLE_ARRAY,
+    };
+
+    void AddToMask(uint32_t& mask, GLint binding)
+    {
+      if (binding >= 0 && binding < 32)
+      {
+        mask |= 1u << binding;
+      }
+    }
+
+    std::string GetResourceName(GLuint program, GLenum interface, GLuint index, GLint nameLength)
+    {
+      std::string name(static_cast<size_t>(nameLength), '\0');
+      glGetProgramResourceName(program, interface, index, nameLength, nullptr, name.data());
+      // the length includes the null terminator
+      if (!name.empty())
+      {
+        name.pop_back();
+      }
+      return name;
+    }
+
+    void ReflectBlocks(GLuint program, GLenum interface, std::vector<ReflectedBlock>& outBlocks, uint32_t& outMask)
+    {
+      GLint count{};
+      glGetProgramInterfaceiv(program, interface, GL_ACTIVE_RESOURCES, &count);
+
+      constexpr std::array<GLenum, 4> properties = {
+        GL_NAME_LENGTH,
+        GL_BUFFER_BINDING,
+        GL_BUFFER_DATA_SIZE,
+        GL_NUM_ACTIVE_VARIABLES,
+      };
+
+      for (GLint i = 0; i < count; i++)
+      {
+        std::array<GLint, properties.size()> values{};
+        glGetProgramResourceiv(program,
+                               interface,
+                               static_cast<GLuint>(i),
+                               static_cast<GLsizei>(properties.size()),
+                               properties.data(),
+                               static_cast<GLsizei>(values.size()),
+                               nullptr,
+                               values.data());
+
+        outBlocks.push_back({
+          .name = GetResourceName(program, interface, static_cast<GLuint>(i), values[0]),
+          .binding = static_cast<uint32_t>(values[1]),
+          .dataSize = static_cast<uint64_t>(values[2]),
+          .activeVariableCount = static_cast<uint32_t>(values[3]),
+        });
+        AddToMask(outMask, values[1]);
+      }
+    }
+
+    // samplers and images in the default uniform block; their units are the values of the uniforms
+    void ReflectOpaqueUniforms(GLuint program, PipelineReflection& reflection)
+    {
+      GLint count{};
+      glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &count);
+
+      constexpr std::array<GLenum, 5> properties = {
+        GL_NAME_LENGTH,
+        GL_TYPE,
+        GL_ARRAY_SIZE,
+        GL_LOCATION,
+        GL_BLOCK_INDEX,
+      };
+
+      for (GLint i = 0; i < count; i++)
+      {
+        std::array<GLint, properties.size()> values{};
+        glGetProgramResourceiv(program,
+                               GL_UNIFORM,
+                               static_cast<GLuint>(i),
+                               static_cast<GLsizei>(properties.size()),
+                               properties.data(),
+                               static_cast<GLsizei>(values.size()),
+                               nullptr,
+                               values.data());
+
+        const auto type = static_cast<GLenum>(values[1]);
+        const GLint arraySize = values[2];
+        const GLint location = values[3];
+        if (location < 0 || values[4] != -1)
+        {
+          continue;
+        }
+
+        const bool isSampler = std::ranges::find(SAMPLER_TYPES, type) != SAMPLER_TYPES.end();
+        const bool isImage = std::ranges::find(IMAGE_TYPES, type) != IMAGE_TYPES.end();
+        if (!isSampler && !isImage)
+        {
+          continue;
+        }
+
+        auto& mask = isSampler ? reflection.sampledImageMask : reflection.imageMask;
+        GLint firstBinding{};
+        for (GLint element = 0; element < arraySize; element++)
+        {
+          GLint binding{};
+          glGetUniformiv(program, location + element, &binding);
+          AddToMask(mask, binding);
+          if (element == 0)
+          {
+            firstBinding = binding;
+          }
+        }
+
+        auto& uniforms = isSampler ? reflection.sampledImages : reflection.images;
+        uniforms.push_back({
+          .name = GetResourceName(program, GL_UNIFORM, static_cast<GLuint>(i), values[0]),
+          .binding = static_cast<uint32_t>(firstBinding),
+          .arraySize = static_cast<uint32_t>(arraySize),
+        });
+      }
+    }
+  } // namespace
+
+  PipelineReflection ReflectProgram(uint32_t program, bool isCompute)
+  {
+    PipelineReflection reflection;
+    ReflectBlocks(program, GL_UNIFORM_BLOCK, reflection.uniformBlocks, reflection.uniformBufferMask);
+    ReflectBlocks(program, GL_SHADER_STORAGE_BLOCK, reflection.storageBlocks, reflection.storageBufferMask);
+    ReflectOpaqueUniforms(program, reflection);
+
+    // querying the workgroup size of a program without a compute shader is an error
+    if (isCompute)
+    {
+      GLint workgroupSize[3]{};
+      glGetProgramiv(program, GL_COMPUTE_WORK_GROUP_SIZE, workgroupSize);
+      reflection.workgroupSize = {
+        static_cast<uint32_t>(workgroupSize[0]),
+        static_cast<uint32_t>(workgroupSize[1]),
+        static_cast<uint32_t>(workgroupSize[2]),
+      };
+    }
+
+    return reflection;
+  }
+} // namespace Fwog::detail
@@ -1,68 +1,185 @@
 #include "Fwog/detail/VertexArrayCache.h"
 #include "Fwog/Common.h"
-#include "Fwog/Pipeline.h"
 #include "Fwog/detail/ApiToEnum.h"
 #include "Fwog/detail/Hash.h"
-#include "Fwog/detail/PipelineManager.h"
+#include <algorithm>
+#include <bit>
+#include <utility>
 
 namespace Fwog::detail
 {
   namespace
   {
-    size_t VertexInputStateHash(const VertexInputStateOwning& k)
-    {
-      size_t hashVal{};
+    constexpr size_t INITIAL_SLOT_COUNT = 16;
 
-      for (const auto& desc : k.vertexBindingDescriptions)
+    uint32_t CreateVertexArray(std::span<const VertexInputBindingDescription> bindingDescriptions)
+    {
+      uint32_t vao{};
+      glCreateVertexArrays(1, &vao);
+      for (uint32_t i = 0; i < bindingDescriptions.size(); i++)
       {
-        auto cctup = std::make_tuple(desc.location, desc.binding, desc.format, desc.offset);
-        auto chashVal = Fwog::detail::hashing::hash<decltype(cctup)>{}(cctup);
-        Fwog::detail::hashing::hash_combine(hashVal, chashVal);
+        const auto& desc = bindingDescriptions[i];
+        glEnableVertexArrayAttrib(vao, i);
+        glVertexArrayAttribBinding(vao, i, desc.binding);
+
+        auto type = detail::FormatToTypeGL(desc.format);
+        auto size = detail::FormatToSizeGL(desc.format);
+        auto normalized = detail::IsFormatNormalizedGL(desc.format);
+        auto internalType = detail::FormatToFormatClass(desc.format);
+        switch (internalType)
+        {
+        case detail::GlFormatClass::FLOAT: glVertexArrayAttribFormat(vao, i, size, type, normalized, desc.offset); break;
+        case detail::GlFormatClass::INT: glVertexArrayAttribIFormat(vao, i, size, type, desc.offset); break;
+        case detail::GlFormatClass::LONG: glVertexArrayAttribLFormat(vao, i, size, type, desc.offset); break;
+        default: FWOG_UNREACHABLE;
+        }
       }
 
-      return hashVal;
+      return vao;
     }
   } // namespace
 
-  uint32_t VertexArrayCache::CreateOrGetCachedVertexArray(const VertexInputStateOwning& inputState)
+  void VertexArrayState::BindVertexBuffer(uint32_t bindingIndex, GLuint buffer, GLintptr offset, GLsizei stride)
+  {
+    if (bindingIndex >= MAX_TRACKED_VERTEX_BUFFERS)
+    {
+      glVertexArrayVertexBuffer(vao_, bindingIndex, buffer, offset, stride);
+      return;
+    }
+
+    if (buffers_[bindingIndex] == buffer && offsets_[bindingIndex] == offset && strides_[bindingIndex] == stride)
+    {
+      return;
+    }
+
+    buffers_[bindingIndex] = buffer;
+    offsets_[bindingIndex] = offset;
+    strides_[bindingIndex] = stride;
+    dirty_ |= 1u << bindingIndex;
+  }
+
+  void VertexArrayState::BindIndexBuffer(GLuint buffer)
+  {
+    if (indexBuffer_ != buffer)
+    {
+      glVertexArrayElementBuffer(vao_, buffer);
+      indexBuffer_ = buffer;
+    }
+  }
+
+  // Clean bindings inside the range are attached again with their current values, which does not change any state.
+  void VertexArrayState::Flush()
   {
-    auto inputHash = VertexInputStateHash(inputState);
-    if (auto it = vertexArrayCache_.find(inputHash); it != vertexArrayCache_.end())
+    if (dirty_ == 0)
     {
-      return it->second;
+      return;
     }
 
-    uint32_t vao{};
-    glCreateVertexArrays(1, &vao);
-    for (uint32_t i = 0; i < inputState.vertexBindingDescriptions.size(); i++)
+    const auto first = static_cast<uint32_t>(std::countr_zero(dirty_));
+    const auto count = static_cast<uint32_t>(std::bit_width(dirty_)) - first;
+    glVertexArrayVertexBuffers(vao_,
+                               first,
+                               static_cast<GLsizei>(count),
+                               &buffers_[first],
+                               &offsets_[first],
+                               &strides_[first]);
+    dirty_ = 0;
+  }
+
+  // the shadow state is reset without marking anything dirty, since drawing with a deleted buffer is an error anyway
+  void VertexArrayState::RemoveBuffer(GLuint buffer)
+  {
+    for (uint32_t i = 0; i < MAX_TRACKED_VERTEX_BUFFERS; i++)
     {
-      const auto& desc = inputState.vertexBindingDescriptions[i];
-      glEnableVertexArrayAttrib(vao, i);
-      glVertexArrayAttribBinding(vao, i, desc.binding);
-
-      auto type = detail::FormatToTypeGL(desc.format);
-      auto size = detail::FormatToSizeGL(desc.format);
-      auto normalized = detail::IsFormatNormalizedGL(desc.format);
-      auto internalType = detail::FormatToFormatClass(desc.format);
-      switch (internalType)
+      if (buffers_[i] == buffer)
       {
-      case detail::GlFormatClass::FLOAT: glVertexArrayAttribFormat(vao, i, size, type, normalized, desc.offset); break;
-      case detail::GlFormatClass::INT: glVertexArrayAttribIFormat(vao, i, size, type, desc.offset); break;
-      case detail::GlFormatClass::LONG: glVertexArrayAttribLFormat(vao, i, size, type, desc.offset); break;
-      default: FWOG_UNREACHABLE;
+        buffers_[i] = 0;
+        offsets_[i] = 0;
+        strides_[i] = 0;
       }
     }
 
-    return vertexArrayCache_.insert({inputHash, vao}).first->second;
+    if (indexBuffer_ == buffer)
+    {
+      indexBuffer_ = 0;
+    }
+  }
+
+  VertexArrayState* VertexArrayCache::CreateOrGetCachedVertexArray(
+    std::span<const VertexInputBindingDescription> bindingDescriptions)
+  {
+    // the descriptions consist of 32-bit members, so they have no padding
+    const uint64_t hash = hashing::fnv1a(bindingDescriptions.data(), bindingDescriptions.size_bytes());
+
+    // keep the load factor at or below one half so probe sequences stay short
+    if ((size_ + 1) * 2 > slots_.size())
+    {
+      Grow();
+    }
+
+    auto& slot = FindSlot(bindingDescriptions, hash);
+    if (!slot.state)
+    {
+      slot = {
+        {bindingDescriptions.begin(), bindingDescriptions.end()},
+        hash,
+        std::make_unique<VertexArrayState>(CreateVertexArray(bindingDescriptions)),
+      };
+      size_++;
+    }
+
+    return slot.state.get();
   }
 
   void VertexArrayCache::Clear()
   {
-    for (auto [_, vao] : vertexArrayCache_)
+    for (const auto& slot : slots_)
     {
-      glDeleteVertexArrays(1, &vao);
+      if (slot.state)
+      {
+        const GLuint vao = slot.state->Handle();
+        glDeleteVertexArrays(1, &vao);
+      }
     }
 
-    vertexArrayCache_.clear();
+    slots_.clear();
+    size_ = 0;
+  }
+
+  void VertexArrayCache::RemoveBuffer(GLuint buffer)
+  {
+    for (auto& slot : slots_)
+    {
+      if (slot.state)
+      {
+        slot.state->RemoveBuffer(buffer);
+      }
+    }
+  }
+
+  VertexArrayCache::Slot& VertexArrayCache::FindSlot(std::span<const VertexInputBindingDescription> bindingDescriptions,
+                                                     uint64_t hash)
+  {
+    const size_t mask = slots_.size() - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask)
+    {
+      auto& slot = slots_[i];
+      if (!slot.state || (slot.hash == hash && std::ranges::equal(slot.bindingDescriptions, bindingDescriptions)))
+      {
+        return slot;
+      }
+    }
+  }
+
+  void VertexArrayCache::Grow()
+  {
+    auto oldSlots = std::exchange(slots_, std::vector<Slot>(std::max(slots_.size() * 2, INITIAL_SLOT_COUNT)));
+    for (auto& slot : oldSlots)
+    {
+      if (slot.state)
+      {
+        FindSlot(slot.bindingDescriptions, slot.hash) = std::move(slot);
+      }
+    }
   }
 } // namespace Fwog::detail